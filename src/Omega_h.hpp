@@ -7,6 +7,7 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <Omega_h_c.h>
@@ -97,6 +98,38 @@ class Write {
 std::size_t get_current_bytes();
 std::size_t get_max_bytes();
 
+/* while a MemoryLabel is alive, arrays created by the host
+   code are charged to its name, so the high-water mark
+   of e.g. "adj" or "ghost" can be queried separately.
+   labels nest; the innermost one wins */
+class MemoryLabel {
+ public:
+  MemoryLabel(std::string const& name);
+  ~MemoryLabel();
+  MemoryLabel(MemoryLabel const&) = delete;
+  MemoryLabel& operator=(MemoryLabel const&) = delete;
+
+ private:
+  Int previous_;
+};
+
+std::size_t get_current_bytes(std::string const& label);
+std::size_t get_max_bytes(std::string const& label);
+/* lowers every label's high-water mark to its current usage.
+   the overall get_max_bytes() is never reset */
+void reset_max_label_bytes();
+void print_memory_report(std::ostream& stream);
+
+/* without Kokkos, arrays are allocated from a cache of
+   freed blocks. the cache holds at most max_bytes, or
+   a quarter of the most bytes ever in use at once if
+   max_bytes is zero (the default) */
+std::size_t get_pool_hits();
+std::size_t get_pool_misses();
+std::size_t get_pool_cached_bytes();
+void set_pool_max_cached_bytes(std::size_t max_bytes);
+void trim_pool();
+
 template <typename T>
 OMEGA_H_INLINE Write<T>::Write()
     :
@@ -261,6 +294,62 @@ class Comm;
 
 typedef std::shared_ptr<Comm> CommPtr;
 
+/* MPI is given the arrays themselves unless they live in
+   device memory that the MPI library cannot read */
+#if defined(OMEGA_H_USE_CUDA) && !defined(OMEGA_H_USE_CUDA_AWARE_MPI)
+#define OMEGA_H_MPI_NEEDS_HOST_COPY
+#endif
+
+/* a neighborhood alltoallv that has been started by
+   Comm::ialltoallv. the buffers it holds must stay alive
+   until Comm::wait has returned the received data */
+template <typename T>
+struct AlltoallvRequest {
+  Read<T> result;
+#ifdef OMEGA_H_USE_MPI
+#ifdef OMEGA_H_MPI_NEEDS_HOST_COPY
+  HostRead<T> sendbuf;
+  HostWrite<T> recvbuf;
+#else
+  Read<T> sendbuf;
+  Write<T> recvbuf;
+#endif
+  HostRead<LO> sendcounts;
+  HostRead<LO> sdispls;
+  HostRead<LO> recvcounts;
+  HostRead<LO> rdispls;
+  std::vector<MPI_Request> requests;
+#endif
+};
+
+/* an allreduce started by Comm::iallreduce. the value lives
+   on the heap so that copies of the request stay valid while
+   MPI writes to it */
+template <typename T>
+struct AllreduceRequest {
+  std::shared_ptr<T> value;
+#ifdef OMEGA_H_USE_MPI
+  MPI_Request request;
+#endif
+};
+
+/* a few scalars, each with its own operation, that one
+   call to Comm::allreduce reduces together. add() returns
+   the slot from which the result is read afterwards */
+struct AllreduceBatch {
+  struct Entry {
+    Real real;
+    GO integer;
+    I32 op;
+    I32 is_integer;
+  };
+  std::vector<Entry> entries;
+  Int add(Real value, Omega_h_Op op);
+  Int add(GO value, Omega_h_Op op);
+  Real get_real(Int slot) const;
+  GO get_integer(Int slot) const;
+};
+
 class Comm {
 #ifdef OMEGA_H_USE_MPI
   MPI_Comm impl_;
@@ -269,6 +358,8 @@ class Comm {
   HostRead<I32> host_srcs_;
   Read<I32> dsts_;
   HostRead<I32> host_dsts_;
+  mutable CommPtr node_comm_;
+  mutable I32 node_comm_ranks_;
 
  public:
   Comm();
@@ -284,6 +375,8 @@ class Comm {
   I32 size() const;
   CommPtr dup() const;
   CommPtr split(I32 color, I32 key) const;
+  CommPtr split_shared() const;
+  CommPtr node_comm(I32 ranks_per_node) const;
   CommPtr graph(Read<I32> dsts) const;
   CommPtr graph_adjacent(Read<I32> srcs, Read<I32> dsts) const;
   CommPtr graph_inverse() const;
@@ -291,9 +384,17 @@ class Comm {
   Read<I32> destinations() const;
   template <typename T>
   T allreduce(T x, Omega_h_Op op) const;
+  template <typename T>
+  void allreduce(T x[], Int n, Omega_h_Op op) const;
+  void allreduce(AllreduceBatch& batch) const;
+  template <typename T>
+  AllreduceRequest<T> iallreduce(T x, Omega_h_Op op) const;
+  template <typename T>
+  T wait(AllreduceRequest<T>& request) const;
   bool reduce_or(bool x) const;
   bool reduce_and(bool x) const;
   Int128 add_int128(Int128 x) const;
+  void add_int128(Int128 x[], Int n) const;
   template <typename T>
   T exscan(T x, Omega_h_Op op) const;
   template <typename T>
@@ -306,9 +407,62 @@ class Comm {
   template <typename T>
   Read<T> alltoallv(Read<T> sendbuf, Read<LO> sendcounts, Read<LO> sdispls,
       Read<LO> recvcounts, Read<LO> rdispls) const;
+  template <typename T>
+  AlltoallvRequest<T> ialltoallv(Read<T> sendbuf, Read<LO> sendcounts,
+      Read<LO> sdispls, Read<LO> recvcounts, Read<LO> rdispls) const;
+  template <typename T>
+  Read<T> wait(AlltoallvRequest<T>& request) const;
   void barrier() const;
 };
 
+/* the number of messages carrying data that this rank has
+   sent to other ranks through Comm::ialltoallv */
+std::size_t get_messages_sent();
+void reset_messages_sent();
+
+/* when enabled, Dist exchanges send the data bound for
+   another node to a leader rank on that node, which forwards
+   it, so each rank sends one message per remote node rather
+   than one per remote neighbor. nodes are the groups of ranks
+   that share memory, or if ranks_per_node is positive, runs
+   of that many consecutive ranks (useful for trying this on
+   one machine). both stages complete in Dist::exch_start */
+void set_node_aware_exchanges(bool enabled, I32 ranks_per_node = 0);
+bool node_aware_exchanges();
+
+/* opt-in profiling of collectives. while it is enabled, each
+   Comm call adds to its collective's count of calls, bytes
+   sent by this rank, neighbors sent to, and seconds spent,
+   all charged to the innermost live CommRegion ("other"
+   outside of any region) */
+void set_comm_profiling(bool enabled);
+bool comm_profiling();
+void reset_comm_profile();
+void print_comm_profile_json(std::ostream& stream, I32 rank);
+/* each rank of comm writes <prefix>_<rank>.json */
+void write_comm_profile(CommPtr comm, std::string const& prefix);
+
+class CommRegion {
+ public:
+  CommRegion(std::string const& name);
+  ~CommRegion();
+  CommRegion(CommRegion const&) = delete;
+  CommRegion& operator=(CommRegion const&) = delete;
+
+ private:
+  Int previous_;
+};
+
+/* an exchange started by Dist::exch_start. its data can be
+   sent while the caller does unrelated local work, and is
+   ready once it is passed to Dist::exch_finish */
+template <typename T>
+struct DistExchange {
+  AlltoallvRequest<T> request;
+  LOs items2content;
+  Int width;
+};
+
 class Dist {
   CommPtr parent_comm_;
   LOs roots2items_[2];
@@ -329,6 +483,10 @@ class Dist {
   template <typename T>
   Read<T> exch(Read<T> data, Int width) const;
   template <typename T>
+  DistExchange<T> exch_start(Read<T> data, Int width) const;
+  template <typename T>
+  Read<T> exch_finish(DistExchange<T>& exchange) const;
+  template <typename T>
   Read<T> exch_reduce(Read<T> data, Int width, Omega_h_Op op) const;
   CommPtr parent_comm() const;
   CommPtr comm() const;
@@ -348,7 +506,31 @@ class Dist {
   Remotes exch(Remotes data, Int width) const;
 
  private:
+  /* the counts and displacements of one exchange width */
+  struct Plan {
+    Int width;
+    LOs sendcounts;
+    LOs sdispls;
+    LOs recvcounts;
+    LOs rdispls;
+  };
+  /* state derived from the maps above, shared by copies of
+     this Dist and dropped whenever the maps it depends on
+     change. plans and the hierarchy only depend on the
+     forward messages */
+  struct Hierarchy;
+  struct Cache {
+    std::vector<Plan> plans;
+    std::shared_ptr<Dist> inverse;
+    std::shared_ptr<Hierarchy> hierarchy;
+  };
   void copy(Dist const& other);
+  void forget_cache();
+  void forget_inverse();
+  Plan ask_plan(Int width) const;
+  Hierarchy const& ask_hierarchy() const;
+  std::shared_ptr<Cache> cache_;
+  bool is_stage_;
   enum { F, R };
 };
 
@@ -447,6 +629,17 @@ class Mesh {
   Adj ask_up(Int from, Int to);
   Graph ask_star(Int dim);
   Graph ask_dual();
+  /* derived adjacencies and the "length" and "quality" tags
+     are caches that can always be recomputed. with a nonzero
+     budget, the least recently used unpinned ones are dropped
+     whenever their total size exceeds it */
+  void set_cache_budget(std::size_t bytes);
+  std::size_t cache_budget() const;
+  std::size_t cached_bytes() const;
+  void pin_adj(Int from, Int to, bool pinned = true);
+  void drop_adj(Int from, Int to);
+  void pin_cached_tag(std::string const& name, bool pinned = true);
+  void drop_caches();
 
  public:
   typedef std::shared_ptr<TagBase> TagPtr;
@@ -458,26 +651,47 @@ class Mesh {
   typedef std::vector<TagPtr> TagVector;
   typedef TagVector::iterator TagIter;
   typedef TagVector::const_iterator TagCIter;
+  typedef std::unordered_map<std::string, std::size_t> TagIndex;
   TagIter tag_iter(Int dim, std::string const& name);
   TagCIter tag_iter(Int dim, std::string const& name) const;
+  void index_tags(Int dim);
   void check_dim(Int dim) const;
   void check_dim2(Int dim) const;
   void add_adj(Int from, Int to, Adj adj);
   Adj derive_adj(Int from, Int to);
   Adj ask_adj(Int from, Int to);
   void react_to_set_tag(Int dim, std::string const& name);
+  void sync_packed_tags(Int dim, std::vector<TagBase const*> const& tags);
+  GO ask_sync_packed_rows(Int dim);
+  enum { LENGTH_CACHE = DIMS * DIMS, QUALITY_CACHE, NCACHES };
+  bool is_derived_adj(Int from, Int to) const;
+  Int cached_tag_slot(std::string const& name) const;
+  bool has_cache(Int slot) const;
+  std::size_t cache_bytes(Int slot) const;
+  void drop_cache(Int slot);
+  void touch_cache(Int slot);
+  void enforce_cache_budget(Int keep_slot);
   Int dim_;
   CommPtr comm_;
   Int parting_;
   Int nghost_layers_;
   LO nents_[DIMS];
   TagVector tags_[DIMS];
+  /* maps names to positions in tags_, which keeps
+     the order tags were added in for file output */
+  TagIndex tag_indices_[DIMS];
   AdjPtr adjs_[DIMS][DIMS];
   Remotes owners_[DIMS];
   DistPtr dists_[DIMS];
+  /* the bound for packing tags synced through dists_, or -1 */
+  GO sync_packed_rows_[DIMS];
   RibPtr rib_hints_;
   bool keeps_canonical_globals_;
   Library* library_;
+  std::size_t cache_budget_;
+  std::size_t cache_clock_;
+  std::size_t cache_uses_[NCACHES];
+  bool cache_pins_[NCACHES];
 
  public:
   void add_coords(Reals array);
@@ -496,10 +710,21 @@ class Mesh {
   void set_parting(Omega_h_Parting parting, bool verbose = false);
   void migrate(Remotes new_elems2old_owners, bool verbose = false);
   void reorder();
-  void balance(bool predictive = false);
+  void balance(
+      bool predictive = false, Omega_h_Partitioner partitioner = OMEGA_H_RIB);
+  /* moves all elements onto the first (nparts) ranks, after which
+     those ranks may call set_comm() with a communicator of just
+     themselves. collective over the current communicator */
+  void merge_parts(I32 nparts);
   Graph ask_graph(Int from, Int to);
   template <typename T>
   Read<T> sync_array(Int ent_dim, Read<T> a, Int width);
+  /* split form of sync_array, so that work which does not
+     need the synced values can overlap the communication */
+  template <typename T>
+  DistExchange<T> sync_array_start(Int ent_dim, Read<T> a, Int width);
+  template <typename T>
+  Read<T> sync_array_finish(Int ent_dim, DistExchange<T>& exchange);
   template <typename T>
   Read<T> sync_subset_array(
       Int ent_dim, Read<T> a_data, LOs a2e, T default_val, Int width);
@@ -508,6 +733,9 @@ class Mesh {
   template <typename T>
   Read<T> owned_array(Int ent_dim, Read<T> a, Int width);
   void sync_tag(Int dim, std::string const& name);
+  /* syncs several tags with one exchange, or a few when the
+     packed tags would be too large for one LO-indexed array */
+  void sync_tags(Int dim, std::vector<std::string> const& names);
   void reduce_tag(Int dim, std::string const& name, Omega_h_Op op);
   bool operator==(Mesh& other);
   Real min_quality();
@@ -568,6 +796,13 @@ class FullWriter {
 
 enum Verbosity { SILENT, EACH_ADAPT, EACH_REBUILD, EXTRA_STATS };
 
+/* how independent sets of cavities are chosen. INDSET_QUALITY
+   takes local maxima of quality, which can need many rounds
+   when quality varies steadily along a front. INDSET_RANDOM
+   compares coarse quality bins first and random priorities
+   within a bin, which bounds those chains */
+enum IndsetStrategy { INDSET_QUALITY, INDSET_RANDOM };
+
 struct AdaptOpts {
   AdaptOpts(Mesh* mesh);  // sets defaults
   Real min_length_desired;
@@ -579,6 +814,7 @@ struct AdaptOpts {
   Verbosity verbosity;
   Real length_histogram_min;
   Real length_histogram_max;
+  IndsetStrategy indset_strategy;
 };
 
 /* returns false if the mesh was not modified. */
@@ -614,6 +850,20 @@ Real repro_sum(CommPtr comm, Reals a);
 void repro_sum(CommPtr comm, Reals a, Int ncomps, Real result[]);
 Real repro_sum_owned(Mesh* mesh, Int dim, Reals a);
 
+/* the element weights Mesh::balance(predictive) partitions by */
+Reals get_balance_masses(Mesh* mesh, bool predictive);
+
+/* how well an element-based partitioning does: the number of
+   sides shared by two ranks, the largest element count over
+   the average element count, and the same ratio for the total
+   element masses (every element weighs one if none are given) */
+struct PartitionStats {
+  GO cut_sides;
+  Real imbalance;
+  Real mass_imbalance;
+};
+PartitionStats get_partition_stats(Mesh* mesh, Reals masses = Reals());
+
 OMEGA_H_INLINE bool code_is_flipped(I8 code) { return code & 1; }
 
 OMEGA_H_INLINE Int code_rotation(I8 code) { return (code >> 1) & 3; }
@@ -656,6 +906,10 @@ class Few {
   enum { size = n };
   OMEGA_H_INLINE T& operator[](Int i) { return array_[i]; }
   OMEGA_H_INLINE T const& operator[](Int i) const { return array_[i]; }
+  OMEGA_H_INLINE volatile T& operator[](Int i) volatile { return array_[i]; }
+  OMEGA_H_INLINE const volatile T& operator[](Int i) const volatile {
+    return array_[i];
+  }
   OMEGA_H_INLINE Few() {}
   Few(std::initializer_list<T> l) {
     Int i = 0;
@@ -702,6 +956,7 @@ bool ends_with(std::string const& s, std::string const& suffix);
   extern template Read<I8> each_eq_to(Read<T> a, T b);                         \
   extern template Read<T> multiply_each_by(T factor, Read<T> x);               \
   extern template T Comm::allreduce(T x, Omega_h_Op op) const;                 \
+  extern template void Comm::allreduce(T x[], Int n, Omega_h_Op op) const;     \
   extern template T Comm::exscan(T x, Omega_h_Op op) const;                    \
   extern template void Comm::bcast(T& x) const;                                \
   extern template Read<T> Comm::allgather(T x) const;                          \
@@ -709,7 +964,17 @@ bool ends_with(std::string const& s, std::string const& suffix);
   extern template Read<T> Comm::alltoallv(Read<T> sendbuf,                     \
       Read<LO> sendcounts, Read<LO> sdispls, Read<LO> recvcounts,              \
       Read<LO> rdispls) const;                                                 \
+  extern template AlltoallvRequest<T> Comm::ialltoallv(Read<T> sendbuf,        \
+      Read<LO> sendcounts, Read<LO> sdispls, Read<LO> recvcounts,              \
+      Read<LO> rdispls) const;                                                 \
+  extern template Read<T> Comm::wait(AlltoallvRequest<T> & request) const;     \
+  extern template AllreduceRequest<T> Comm::iallreduce(T x, Omega_h_Op op)     \
+      const;                                                                   \
+  extern template T Comm::wait(AllreduceRequest<T> & request) const;           \
   extern template Read<T> Dist::exch(Read<T> data, Int width) const;           \
+  extern template DistExchange<T> Dist::exch_start(Read<T> data, Int width)    \
+      const;                                                                   \
+  extern template Read<T> Dist::exch_finish(DistExchange<T> & exchange) const; \
   extern template Read<T> Dist::exch_reduce<T>(                                \
       Read<T> data, Int width, Omega_h_Op op) const;                           \
   extern template Tag<T> const* Mesh::get_tag<T>(                              \
@@ -723,6 +988,10 @@ bool ends_with(std::string const& s, std::string const& suffix);
   extern template void Mesh::set_tag(                                          \
       Int dim, std::string const& name, Read<T> array, bool internal);         \
   extern template Read<T> Mesh::sync_array(Int ent_dim, Read<T> a, Int width); \
+  extern template DistExchange<T> Mesh::sync_array_start(                      \
+      Int ent_dim, Read<T> a, Int width);                                      \
+  extern template Read<T> Mesh::sync_array_finish(                             \
+      Int ent_dim, DistExchange<T> & exchange);                                \
   extern template Read<T> Mesh::owned_array(                                   \
       Int ent_dim, Read<T> a, Int width);                                      \
   extern template Read<T> Mesh::sync_subset_array(                             \
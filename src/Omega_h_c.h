@@ -40,6 +40,13 @@ enum Omega_h_Parting {
   OMEGA_H_VERT_BASED,
 };
 
+/* OMEGA_H_RIB is recursive inertial bisection.
+   OMEGA_H_GRAPH follows RIB with a greedy positive-gain sweep
+   that moves boundary elements to neighboring parts to cut fewer
+   sides (no negative-gain moves or rollback, so not KL/FM).
+   OMEGA_H_HILBERT cuts a Hilbert curve through element centers */
+enum Omega_h_Partitioner { OMEGA_H_RIB, OMEGA_H_GRAPH, OMEGA_H_HILBERT };
+
 enum Omega_h_Comparison { OMEGA_H_SAME, OMEGA_H_MORE, OMEGA_H_DIFF };
 
 enum Omega_h_Outflags {
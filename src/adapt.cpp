@@ -4,6 +4,7 @@
 #include "array.hpp"
 #include "coarsen.hpp"
 #include "histogram.hpp"
+#include "indset.hpp"
 #include "mark.hpp"
 #include "quality.hpp"
 #include "refine.hpp"
@@ -29,22 +30,73 @@ AdaptOpts::AdaptOpts(Mesh* mesh) {
   verbosity = EACH_REBUILD;
   length_histogram_min = 0.0;
   length_histogram_max = 3.0;
+  indset_strategy = INDSET_QUALITY;
 }
 
-static void goal_stats(Mesh* mesh, char const* name, Int ent_dim, Reals values,
-    Real floor, Real ceil, Real minval, Real maxval) {
-  auto low_marks = each_lt(values, floor);
-  auto high_marks = each_gt(values, ceil);
-  auto nlow = count_owned_marks(mesh, ent_dim, low_marks);
-  auto nhigh = count_owned_marks(mesh, ent_dim, high_marks);
-  auto ntotal = mesh->nglobal_ents(ent_dim);
+/* adapt_check reduces the extremes of quality and length in
+   one batch. only if the mesh is not good and the stats will
+   be printed does a second batch reduce the counts of
+   entities below, inside and above the goal range */
+struct GoalStats {
+  char const* name;
+  Int ent_dim;
+  Reals values;
+  Real floor;
+  Real ceil;
+  Int min_slot;
+  Int max_slot;
+  Int nlow_slot;
+  Int nhigh_slot;
+  Int ntotal_slot;
+};
+
+static LO count_owned(Mesh* mesh, Int ent_dim) {
+  if (!mesh->could_be_shared(ent_dim)) return mesh->nents(ent_dim);
+  return sum(mesh->owned(ent_dim));
+}
+
+static GoalStats add_goal_extremes(AllreduceBatch& batch, char const* name,
+    Int ent_dim, Reals values, Real floor, Real ceil) {
+  GoalStats stats;
+  stats.name = name;
+  stats.ent_dim = ent_dim;
+  stats.values = values;
+  stats.floor = floor;
+  stats.ceil = ceil;
+  stats.min_slot = batch.add(min(values), OMEGA_H_MIN);
+  stats.max_slot = batch.add(max(values), OMEGA_H_MAX);
+  stats.nlow_slot = stats.nhigh_slot = stats.ntotal_slot = -1;
+  return stats;
+}
+
+static void add_goal_counts(
+    Mesh* mesh, AllreduceBatch& batch, GoalStats* stats) {
+  auto ent_dim = stats->ent_dim;
+  auto nlow = count_local_owned_marks(
+      mesh, ent_dim, each_lt(stats->values, stats->floor));
+  auto nhigh = count_local_owned_marks(
+      mesh, ent_dim, each_gt(stats->values, stats->ceil));
+  stats->nlow_slot = batch.add(GO(nlow), OMEGA_H_SUM);
+  stats->nhigh_slot = batch.add(GO(nhigh), OMEGA_H_SUM);
+  stats->ntotal_slot = batch.add(GO(count_owned(mesh, ent_dim)), OMEGA_H_SUM);
+}
+
+static void goal_stats(Mesh* mesh, AllreduceBatch const& extremes,
+    AllreduceBatch const& counts, GoalStats const& stats) {
+  auto nlow = counts.get_integer(stats.nlow_slot);
+  auto nhigh = counts.get_integer(stats.nhigh_slot);
+  auto ntotal = counts.get_integer(stats.ntotal_slot);
   auto nmid = ntotal - nlow - nhigh;
+  auto floor = stats.floor;
+  auto ceil = stats.ceil;
   if (mesh->comm()->rank() == 0) {
     auto precision_before = std::cout.precision();
     std::ios::fmtflags stream_state(std::cout.flags());
     std::cout << std::fixed << std::setprecision(2);
-    std::cout << ntotal << " " << plural_names[ent_dim];
-    std::cout << ", " << name << " [" << minval << "," << maxval << "]";
+    std::cout << ntotal << " " << plural_names[stats.ent_dim];
+    std::cout << ", " << stats.name << " ["
+              << extremes.get_real(stats.min_slot) << ","
+              << extremes.get_real(stats.max_slot) << "]";
     if (nlow) {
       std::cout << ", " << nlow << " <" << floor;
     }
@@ -60,25 +112,19 @@ static void goal_stats(Mesh* mesh, char const* name, Int ent_dim, Reals values,
   }
 }
 
-static void get_minmax(
-    Mesh* mesh, Reals values, Real* p_minval, Real* p_maxval) {
-  *p_minval = mesh->comm()->allreduce(min(values), OMEGA_H_MIN);
-  *p_maxval = mesh->comm()->allreduce(max(values), OMEGA_H_MAX);
-}
-
-static void adapt_summary(Mesh* mesh, AdaptOpts const& opts, Real minqual,
-    Real maxqual, Real minlen, Real maxlen) {
-  goal_stats(mesh, "quality", mesh->dim(), mesh->ask_qualities(),
-      opts.min_quality_allowed, opts.min_quality_desired, minqual, maxqual);
-  goal_stats(mesh, "length", EDGE, mesh->ask_lengths(), opts.min_length_desired,
-      opts.max_length_desired, minlen, maxlen);
-}
-
 static bool adapt_check(Mesh* mesh, AdaptOpts const& opts) {
-  Real minqual, maxqual;
-  get_minmax(mesh, mesh->ask_qualities(), &minqual, &maxqual);
-  Real minlen, maxlen;
-  get_minmax(mesh, mesh->ask_lengths(), &minlen, &maxlen);
+  CommRegion region("adapt_check");
+  AllreduceBatch extremes;
+  auto qual_stats = add_goal_extremes(extremes, "quality", mesh->dim(),
+      mesh->ask_qualities(), opts.min_quality_allowed,
+      opts.min_quality_desired);
+  auto len_stats = add_goal_extremes(extremes, "length", EDGE,
+      mesh->ask_lengths(), opts.min_length_desired, opts.max_length_desired);
+  mesh->comm()->allreduce(extremes);
+  auto minqual = extremes.get_real(qual_stats.min_slot);
+  auto maxqual = extremes.get_real(qual_stats.max_slot);
+  auto minlen = extremes.get_real(len_stats.min_slot);
+  auto maxlen = extremes.get_real(len_stats.max_slot);
   if (minqual >= opts.min_quality_desired &&
       minlen >= opts.min_length_desired && maxlen <= opts.max_length_desired) {
     if (opts.verbosity > SILENT && mesh->comm()->rank() == 0) {
@@ -88,7 +134,12 @@ static bool adapt_check(Mesh* mesh, AdaptOpts const& opts) {
     return true;
   }
   if (opts.verbosity > SILENT) {
-    adapt_summary(mesh, opts, minqual, maxqual, minlen, maxlen);
+    AllreduceBatch counts;
+    add_goal_counts(mesh, counts, &qual_stats);
+    add_goal_counts(mesh, counts, &len_stats);
+    mesh->comm()->allreduce(counts);
+    goal_stats(mesh, extremes, counts, qual_stats);
+    goal_stats(mesh, extremes, counts, len_stats);
   }
   return false;
 }
@@ -115,6 +166,28 @@ static void validate(Mesh* mesh, AdaptOpts const& opts) {
   }
 }
 
+/* the per-label high-water marks are reset after each report,
+   so each report covers exactly one pass. they are local to rank 0 */
+static void memory_report(Mesh* mesh, AdaptOpts const& opts) {
+  if (opts.verbosity < EXTRA_STATS) return;
+  if (!mesh->comm()->rank()) print_memory_report(std::cout);
+  reset_max_label_bytes();
+}
+
+/* like the memory report, this covers one pass, and the
+   times are those of rank 0 */
+static void indset_report(Mesh* mesh, AdaptOpts const& opts) {
+  if (opts.verbosity < EXTRA_STATS) return;
+  auto stats = get_indset_stats();
+  if (!mesh->comm()->rank() && stats.nsets) {
+    std::cout << "independent sets ("
+              << (opts.indset_strategy == INDSET_RANDOM ? "random" : "quality")
+              << "): " << stats.nsets << " sets, " << stats.nrounds
+              << " rounds, " << stats.seconds << " seconds\n";
+  }
+  reset_indset_stats();
+}
+
 static bool pre_adapt(Mesh* mesh, AdaptOpts const& opts) {
   validate(mesh, opts);
   if (opts.verbosity >= EACH_ADAPT && !mesh->comm()->rank()) {
@@ -122,6 +195,7 @@ static bool pre_adapt(Mesh* mesh, AdaptOpts const& opts) {
   }
   if (adapt_check(mesh, opts)) return false;
   if (opts.verbosity >= EXTRA_STATS) do_histograms(mesh, opts);
+  memory_report(mesh, opts);
   if ((opts.verbosity >= EACH_REBUILD) && !mesh->comm()->rank()) {
     std::cout << "addressing edge lengths\n";
   }
@@ -130,6 +204,8 @@ static bool pre_adapt(Mesh* mesh, AdaptOpts const& opts) {
 
 static void post_rebuild(Mesh* mesh, AdaptOpts const& opts) {
   if (opts.verbosity >= EACH_REBUILD) adapt_check(mesh, opts);
+  indset_report(mesh, opts);
+  memory_report(mesh, opts);
 }
 
 static void satisfy_lengths(Mesh* mesh, AdaptOpts const& opts) {
@@ -1,17 +1,119 @@
 #include "array.hpp"
 
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
 #include "algebra.hpp"
 #include "loop.hpp"
+#include "pool.hpp"
 
 namespace Omega_h {
 
-static std::size_t current_array_bytes = 0;
+/* array memory is accounted with atomics so that arrays
+   may be created and destroyed from inside parallel loops.
+   each allocation is also charged to the label that was current
+   on the host thread when it was made (see MemoryLabel).
+   label slots are never reused, label 0 is "other". */
+
+enum { MAX_MEMORY_LABELS = 64 };
+
+static std::atomic<std::size_t> current_array_bytes(0);
+static std::atomic<std::size_t> max_array_bytes(0);
+static std::string memory_label_names[MAX_MEMORY_LABELS] = {"other"};
+static std::atomic<std::size_t> current_label_bytes[MAX_MEMORY_LABELS];
+static std::atomic<std::size_t> max_label_bytes[MAX_MEMORY_LABELS];
+static std::atomic<Int> nmemory_labels(1);
+static Int current_memory_label = 0;
+static std::mutex memory_label_mutex;
+
+static void raise_to(std::atomic<std::size_t>& max_bytes, std::size_t bytes) {
+  auto old = max_bytes.load(std::memory_order_relaxed);
+  while (old < bytes &&
+         !max_bytes.compare_exchange_weak(old, bytes, std::memory_order_relaxed))
+    ;
+}
+
+static void track_bytes(Int label, std::size_t bytes) {
+  raise_to(max_array_bytes, current_array_bytes.fetch_add(bytes) + bytes);
+  raise_to(max_label_bytes[label],
+      current_label_bytes[label].fetch_add(bytes) + bytes);
+}
+
+static void untrack_bytes(Int label, std::size_t bytes) {
+  current_array_bytes.fetch_sub(bytes);
+  current_label_bytes[label].fetch_sub(bytes);
+}
+
+static Int find_memory_label(std::string const& name, bool should_add) {
+  std::lock_guard<std::mutex> lock(memory_label_mutex);
+  Int n = nmemory_labels.load();
+  for (Int i = 0; i < n; ++i) {
+    if (memory_label_names[i] == name) return i;
+  }
+  if (!should_add) return -1;
+  if (n == MAX_MEMORY_LABELS) return 0;
+  memory_label_names[n] = name;
+  nmemory_labels.store(n + 1);
+  return n;
+}
+
+std::size_t get_current_bytes() { return current_array_bytes.load(); }
+
+std::size_t get_max_bytes() { return max_array_bytes.load(); }
+
+std::size_t get_current_bytes(std::string const& label) {
+  auto i = find_memory_label(label, false);
+  return (i == -1) ? 0 : current_label_bytes[i].load();
+}
+
+std::size_t get_max_bytes(std::string const& label) {
+  auto i = find_memory_label(label, false);
+  return (i == -1) ? 0 : max_label_bytes[i].load();
+}
+
+void reset_max_label_bytes() {
+  Int n = nmemory_labels.load();
+  for (Int i = 0; i < n; ++i) {
+    max_label_bytes[i].store(current_label_bytes[i].load());
+  }
+}
+
+void print_memory_report(std::ostream& stream) {
+  stream << "array memory: " << get_current_bytes() << " bytes current, "
+         << get_max_bytes() << " bytes peak\n";
+  Int n = nmemory_labels.load();
+  for (Int i = 0; i < n; ++i) {
+    auto max_bytes = max_label_bytes[i].load();
+    if (!max_bytes) continue;
+    stream << "  " << std::setw(16) << std::left << memory_label_names[i]
+           << std::right << std::setw(14) << current_label_bytes[i].load()
+           << " current " << std::setw(14) << max_bytes << " high-water\n";
+  }
+}
 
-std::size_t get_current_bytes() { return current_array_bytes; }
+MemoryLabel::MemoryLabel(std::string const& name)
+    : previous_(current_memory_label) {
+  current_memory_label = find_memory_label(name, true);
+}
 
-static std::size_t max_array_bytes = 0;
+MemoryLabel::~MemoryLabel() { current_memory_label = previous_; }
 
-std::size_t get_max_bytes() { return max_array_bytes; }
+#ifndef OMEGA_H_USE_KOKKOS
+/* the deleter runs exactly once, when the last copy of the
+   array goes away, so it is where the bytes are given back */
+template <typename T>
+struct ArrayDeleter {
+  std::size_t bytes;
+  Int label;
+  ArrayDeleter(std::size_t bytes_, Int label_) : bytes(bytes_), label(label_) {}
+  void operator()(T* ptr) const {
+    untrack_bytes(label, bytes);
+    pool::deallocate(ptr, bytes);
+  }
+};
+#endif
 
 #ifdef OMEGA_H_USE_KOKKOS
 template <typename T>
@@ -22,22 +124,23 @@ template <typename T>
 Write<T>::Write(LO size)
     :
 #ifdef OMEGA_H_USE_KOKKOS
-      view_(Kokkos::ViewAllocateWithoutInitializing("omega_h"),
+      view_(Kokkos::ViewAllocateWithoutInitializing(
+                memory_label_names[current_memory_label]),
           static_cast<std::size_t>(size))
 #else
-      ptr_(new T[size], std::default_delete<T[]>()),
+      ptr_(static_cast<T*>(pool::allocate(static_cast<std::size_t>(size) *
+                                          sizeof(T))),
+          ArrayDeleter<T>(
+              static_cast<std::size_t>(size) * sizeof(T), current_memory_label)),
       size_(size)
 #endif
       ,
       exists_(true) {
 #ifdef OMEGA_H_USE_KOKKOS
-  current_array_bytes += view_.span() * sizeof(T);
+  track_bytes(current_memory_label, view_.span() * sizeof(T));
 #else
-  current_array_bytes += static_cast<std::size_t>(size) * sizeof(T);
+  track_bytes(current_memory_label, static_cast<std::size_t>(size) * sizeof(T));
 #endif
-  if (current_array_bytes > max_array_bytes) {
-    max_array_bytes = current_array_bytes;
-  }
 }
 
 template <typename T>
@@ -45,11 +148,8 @@ void Write<T>::dtor() {
 #ifdef OMEGA_H_USE_KOKKOS
   if (view_.use_count() == 1) {
     CHECK(view_.span() == view_.size());
-    current_array_bytes -= view_.span() * sizeof(T);
-  }
-#else
-  if (ptr_.unique()) {
-    current_array_bytes -= static_cast<std::size_t>(size_) * sizeof(T);
+    auto label = find_memory_label(view_.label(), false);
+    untrack_bytes(max2(label, 0), view_.span() * sizeof(T));
   }
 #endif
 }
@@ -3,10 +3,37 @@
 
 namespace Omega_h {
 
+#if defined(OMEGA_H_USE_OPENMP) && !defined(OMEGA_H_USE_KOKKOS)
+
+/* the native OpenMP backend uses the GCC/Clang __atomic builtins.
+   these accept any integer type directly, but floating-point
+   addition has to go through a compare-and-swap loop */
+
+template <class T>
+inline T native_atomic_fetch_add(volatile T* const dest, const T val) {
+  return __atomic_fetch_add(dest, val, __ATOMIC_RELAXED);
+}
+
+inline double native_atomic_fetch_add(
+    volatile double* const dest, const double val) {
+  double expected;
+  __atomic_load(dest, &expected, __ATOMIC_RELAXED);
+  double desired;
+  do {
+    desired = expected + val;
+  } while (!__atomic_compare_exchange(dest, &expected, &desired, true,
+      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+  return expected;
+}
+
+#endif
+
 template <class T>
 INLINE void atomic_increment(volatile T* const dest) {
-#ifdef OMEGA_H_USE_KOKKOS
+#if defined(OMEGA_H_USE_KOKKOS)
   return Kokkos::atomic_increment(dest);
+#elif defined(OMEGA_H_USE_OPENMP)
+  native_atomic_fetch_add(dest, T(1));
 #else
   ++(*dest);
 #endif
@@ -14,8 +41,10 @@ INLINE void atomic_increment(volatile T* const dest) {
 
 template <class T>
 INLINE void atomic_add(volatile T* const dest, const T val) {
-#ifdef OMEGA_H_USE_KOKKOS
+#if defined(OMEGA_H_USE_KOKKOS)
   return Kokkos::atomic_add(dest, val);
+#elif defined(OMEGA_H_USE_OPENMP)
+  native_atomic_fetch_add(dest, val);
 #else
   *dest += val;
 #endif
@@ -23,8 +52,10 @@ INLINE void atomic_add(volatile T* const dest, const T val) {
 
 template <class T>
 INLINE T atomic_fetch_add(volatile T* const dest, const T val) {
-#ifdef OMEGA_H_USE_KOKKOS
+#if defined(OMEGA_H_USE_KOKKOS)
   return Kokkos::atomic_fetch_add(dest, val);
+#elif defined(OMEGA_H_USE_OPENMP)
+  return native_atomic_fetch_add(dest, val);
 #else
   T tmp = *dest;
   *dest += val;
@@ -8,13 +8,13 @@
 namespace Omega_h {
 
 Dist bi_partition(CommPtr comm, Read<I8> marks) {
-  CHECK(comm->size() % 2 == 0);
   Write<I32> dest_ranks(marks.size());
   Write<LO> dest_idxs(marks.size());
   LO linsize = -1;
-  auto halfsize = comm->size() / 2;
   I32 rank_start = 0;
   for (Int half = 0; half < 2; ++half) {
+    auto halfsize = (half == 0) ? (comm->size() / 2)
+                                : (comm->size() - comm->size() / 2);
     marks = invert_marks(marks);
     auto marked = collect_marked(marks);
     auto total = comm->allreduce(GO(marked.size()), OMEGA_H_SUM);
@@ -12,6 +12,8 @@ namespace Omega_h {
    such that the first half of the ranks have
    all the items marked 0 and the second half
    of the ranks have all the items marked 1.
+   with an odd number of ranks, the second half
+   has one more rank.
    this is a useful subroutine for parallel
    sort-like operations (RIB in particular) */
 
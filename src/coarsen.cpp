@@ -92,14 +92,15 @@ static bool coarsen_ghosted(
   auto vert_rails = Read<GO>();
   choose_rails(mesh, cands2edges, cand_edge_codes, cand_edge_quals,
       &verts_are_cands, &vert_quals, &vert_rails);
-  auto verts_are_keys = find_indset(mesh, VERT, vert_quals, verts_are_cands);
+  auto verts_are_keys = find_indset(
+      mesh, VERT, vert_quals, verts_are_cands, opts.indset_strategy);
   Graph verts2cav_elems;
   if (needs_buffer_layers(mesh)) {
     verts2cav_elems = get_buffered_elems(mesh, VERT, verts_are_keys);
     auto buf_conflicts =
         get_buffered_conflicts(mesh, VERT, verts2cav_elems, verts_are_keys);
-    verts_are_keys =
-        find_indset(mesh, VERT, buf_conflicts, vert_quals, verts_are_keys);
+    verts_are_keys = find_indset(mesh, VERT, buf_conflicts, vert_quals,
+        verts_are_keys, opts.indset_strategy);
   } else {
     verts2cav_elems = mesh->ask_up(VERT, mesh->dim());
   }
@@ -212,6 +213,8 @@ static bool coarsen_ents(Mesh* mesh, AdaptOpts const& opts, Int ent_dim,
 }
 
 bool coarsen_by_size(Mesh* mesh, AdaptOpts const& opts) {
+  MemoryLabel label("coarsen");
+  CommRegion region("coarsen");
   auto comm = mesh->comm();
   auto lengths = mesh->ask_lengths();
   auto edge_is_cand = each_lt(lengths, opts.min_length_desired);
@@ -221,6 +224,8 @@ bool coarsen_by_size(Mesh* mesh, AdaptOpts const& opts) {
 }
 
 bool coarsen_slivers(Mesh* mesh, AdaptOpts const& opts) {
+  MemoryLabel label("coarsen");
+  CommRegion region("coarsen");
   mesh->set_parting(OMEGA_H_GHOSTED);
   auto comm = mesh->comm();
   auto elems_are_cands =
@@ -1,7 +1,13 @@
 #include "comm.hpp"
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
 #include "array.hpp"
 #include "int128.hpp"
+#include "timer.hpp"
 
 namespace Omega_h {
 
@@ -9,14 +15,124 @@ namespace Omega_h {
 #define CALL(f) CHECK(MPI_SUCCESS == (f))
 #endif
 
-Comm::Comm() {
+static std::size_t messages_sent = 0;
+
+std::size_t get_messages_sent() { return messages_sent; }
+
+void reset_messages_sent() { messages_sent = 0; }
+
+enum {
+  COMM_ALLREDUCE,
+  COMM_EXSCAN,
+  COMM_BCAST,
+  COMM_ALLGATHER,
+  COMM_ALLTOALL,
+  COMM_ALLTOALLV,
+  COMM_BARRIER,
+  NCOMM_OPS
+};
+
+static char const* const comm_op_names[NCOMM_OPS] = {"allreduce", "exscan",
+    "bcast", "allgather", "alltoall", "alltoallv", "barrier"};
+
+struct CommCounts {
+  std::size_t calls;
+  std::size_t bytes;
+  std::size_t neighbors;
+  Real seconds;
+};
+
+static bool is_profiling = false;
+static std::vector<std::string> comm_region_names(1, "other");
+/* NCOMM_OPS entries per region */
+static std::vector<CommCounts> comm_counts(NCOMM_OPS, CommCounts());
+static Int current_comm_region = 0;
+
+void set_comm_profiling(bool enabled) { is_profiling = enabled; }
+
+bool comm_profiling() { return is_profiling; }
+
+void reset_comm_profile() {
+  for (auto& counts : comm_counts) counts = CommCounts();
+}
+
+void print_comm_profile_json(std::ostream& stream, I32 rank) {
+  stream << "{\n  \"rank\": " << rank << ",\n  \"regions\": {";
+  bool first_region = true;
+  for (std::size_t r = 0; r < comm_region_names.size(); ++r) {
+    bool first_op = true;
+    for (Int op = 0; op < NCOMM_OPS; ++op) {
+      auto& counts = comm_counts[r * NCOMM_OPS + std::size_t(op)];
+      if (!counts.calls) continue;
+      if (first_op) {
+        stream << (first_region ? "" : ",") << "\n    \""
+               << comm_region_names[r] << "\": {";
+        first_region = false;
+      }
+      stream << (first_op ? "" : ",") << "\n      \"" << comm_op_names[op]
+             << "\": {\"calls\": " << counts.calls
+             << ", \"bytes\": " << counts.bytes
+             << ", \"neighbors\": " << counts.neighbors
+             << ", \"seconds\": " << counts.seconds << "}";
+      first_op = false;
+    }
+    if (!first_op) stream << "\n    }";
+  }
+  stream << "\n  }\n}\n";
+}
+
+void write_comm_profile(CommPtr comm, std::string const& prefix) {
+  auto rank = comm->rank();
+  std::stringstream name;
+  name << prefix << '_' << rank << ".json";
+  std::ofstream file(name.str().c_str());
+  CHECK(file.is_open());
+  print_comm_profile_json(file, rank);
+}
+
+CommRegion::CommRegion(std::string const& name)
+    : previous_(current_comm_region) {
+  std::size_t i = 0;
+  while (i < comm_region_names.size() && comm_region_names[i] != name) ++i;
+  if (i == comm_region_names.size()) {
+    comm_region_names.push_back(name);
+    comm_counts.resize(comm_counts.size() + NCOMM_OPS, CommCounts());
+  }
+  current_comm_region = Int(i);
+}
+
+CommRegion::~CommRegion() { current_comm_region = previous_; }
+
+/* charges one collective to the current region. the time
+   is measured until the end of the enclosing scope */
+class CommRecord {
+ public:
+  CommRecord(Int op, std::size_t bytes, Int neighbors, bool is_call = true)
+      : counts_(nullptr) {
+    if (!is_profiling) return;
+    counts_ = &comm_counts[std::size_t(current_comm_region * NCOMM_OPS + op)];
+    if (is_call) ++counts_->calls;
+    counts_->bytes += bytes;
+    counts_->neighbors += std::size_t(neighbors);
+    start_ = now();
+  }
+  ~CommRecord() {
+    if (counts_) counts_->seconds += now() - start_;
+  }
+
+ private:
+  CommCounts* counts_;
+  Now start_;
+};
+
+Comm::Comm() : node_comm_ranks_(-1) {
 #ifdef OMEGA_H_USE_MPI
   impl_ = MPI_COMM_NULL;
 #endif
 }
 
 #ifdef OMEGA_H_USE_MPI
-Comm::Comm(MPI_Comm impl) : impl_(impl) {
+Comm::Comm(MPI_Comm impl) : impl_(impl), node_comm_ranks_(-1) {
   int topo_type;
   CALL(MPI_Topo_test(impl, &topo_type));
   if (topo_type == MPI_DIST_GRAPH) {
@@ -34,7 +150,7 @@ Comm::Comm(MPI_Comm impl) : impl_(impl) {
   }
 }
 #else
-Comm::Comm(bool is_graph, bool sends_to_self) {
+Comm::Comm(bool is_graph, bool sends_to_self) : node_comm_ranks_(-1) {
   if (is_graph) {
     if (sends_to_self) {
       srcs_ = Read<LO>({0});
@@ -118,6 +234,36 @@ CommPtr Comm::split(I32 color, I32 key) const {
 #endif
 }
 
+/* groups the ranks that share memory, i.e. those on one node.
+   MPI older than 3.0 cannot tell, so each rank is its own node */
+CommPtr Comm::split_shared() const {
+#ifdef OMEGA_H_USE_MPI
+#if MPI_VERSION < 3
+  return split(rank(), 0);
+#else
+  MPI_Comm impl2;
+  CALL(MPI_Comm_split_type(
+      impl_, MPI_COMM_TYPE_SHARED, rank(), MPI_INFO_NULL, &impl2));
+  return CommPtr(new Comm(impl2));
+#endif
+#else
+  return CommPtr(new Comm());
+#endif
+}
+
+/* the ranks on this rank's node: runs of ranks_per_node
+   consecutive ranks if that is positive, otherwise those
+   sharing memory. splitting is collective, so the result is
+   kept for later calls with the same ranks_per_node */
+CommPtr Comm::node_comm(I32 ranks_per_node) const {
+  if (node_comm_ && node_comm_ranks_ == ranks_per_node) return node_comm_;
+  auto self = rank();
+  node_comm_ = (ranks_per_node > 0) ? split(self / ranks_per_node, self)
+                                    : split_shared();
+  node_comm_ranks_ = ranks_per_node;
+  return node_comm_;
+}
+
 CommPtr Comm::graph(Read<I32> dsts) const {
 #ifdef OMEGA_H_USE_MPI
   MPI_Comm impl2;
@@ -128,7 +274,21 @@ CommPtr Comm::graph(Read<I32> dsts) const {
   int reorder = 0;
   CALL(MPI_Dist_graph_create(impl_, n, sources, degrees, destinations.data(),
       OMEGA_H_MPI_UNWEIGHTED, MPI_INFO_NULL, reorder, &impl2));
-  return CommPtr(new Comm(impl2));
+  CommPtr unordered(new Comm(impl2));
+  /* MPI may list the sources in any order, and neighbor
+     collectives lay out received data in that order. Dist
+     relies on it being by rank (the lowest ranked copy of a
+     derived entity becomes its owner), so if MPI did not sort
+     them the graph is rebuilt with sorted sources */
+  HostRead<I32> host_srcs(unordered->sources());
+  std::vector<I32> sorted_srcs(
+      host_srcs.data(), host_srcs.data() + host_srcs.size());
+  auto is_sorted = std::is_sorted(sorted_srcs.begin(), sorted_srcs.end());
+  if (reduce_and(is_sorted)) return unordered;
+  std::sort(sorted_srcs.begin(), sorted_srcs.end());
+  HostWrite<I32> srcs(I32(sorted_srcs.size()));
+  for (I32 i = 0; i < srcs.size(); ++i) srcs[i] = sorted_srcs[std::size_t(i)];
+  return graph_adjacent(srcs.write(), dsts);
 #else
   return CommPtr(new Comm(true, dsts.size() == 1));
 #endif
@@ -160,6 +320,7 @@ Read<I32> Comm::destinations() const { return dsts_; }
 
 template <typename T>
 T Comm::allreduce(T x, Omega_h_Op op) const {
+  CommRecord record(COMM_ALLREDUCE, sizeof(T), 0);
 #ifdef OMEGA_H_USE_MPI
   CALL(MPI_Allreduce(
       MPI_IN_PLACE, &x, 1, MpiTraits<T>::datatype(), mpi_op(op), impl_));
@@ -169,6 +330,50 @@ T Comm::allreduce(T x, Omega_h_Op op) const {
   return x;
 }
 
+template <typename T>
+void Comm::allreduce(T x[], Int n, Omega_h_Op op) const {
+  CommRecord record(COMM_ALLREDUCE, sizeof(T) * std::size_t(n), 0);
+#ifdef OMEGA_H_USE_MPI
+  CALL(MPI_Allreduce(
+      MPI_IN_PLACE, x, n, MpiTraits<T>::datatype(), mpi_op(op), impl_));
+#else
+  (void)x;
+  (void)n;
+  (void)op;
+#endif
+}
+
+/* MPI older than 3.0 has no MPI_Iallreduce, so the reduction
+   is done right away and the request is already complete */
+template <typename T>
+AllreduceRequest<T> Comm::iallreduce(T x, Omega_h_Op op) const {
+  CommRecord record(COMM_ALLREDUCE, sizeof(T), 0);
+  AllreduceRequest<T> request;
+  request.value = std::make_shared<T>(x);
+#ifdef OMEGA_H_USE_MPI
+#if MPI_VERSION < 3
+  CALL(MPI_Allreduce(MPI_IN_PLACE, request.value.get(), 1,
+      MpiTraits<T>::datatype(), mpi_op(op), impl_));
+  request.request = MPI_REQUEST_NULL;
+#else
+  CALL(MPI_Iallreduce(MPI_IN_PLACE, request.value.get(), 1,
+      MpiTraits<T>::datatype(), mpi_op(op), impl_, &request.request));
+#endif
+#else
+  (void)op;
+#endif
+  return request;
+}
+
+template <typename T>
+T Comm::wait(AllreduceRequest<T>& request) const {
+  CommRecord record(COMM_ALLREDUCE, 0, 0, false);
+#ifdef OMEGA_H_USE_MPI
+  CALL(MPI_Wait(&request.request, MPI_STATUS_IGNORE));
+#endif
+  return *(request.value);
+}
+
 bool Comm::reduce_or(bool x) const {
   I8 y = x;
   y = allreduce(y, OMEGA_H_MAX);
@@ -182,26 +387,129 @@ bool Comm::reduce_and(bool x) const {
 }
 
 #ifdef OMEGA_H_USE_MPI
-static void mpi_add_int128(void* a, void* b, int*, MPI_Datatype*) {
+static MPI_Datatype int128_type = MPI_DATATYPE_NULL;
+static MPI_Op int128_add_op = MPI_OP_NULL;
+
+static void mpi_add_int128(void* a, void* b, int* len, MPI_Datatype*) {
   Int128* a2 = static_cast<Int128*>(a);
   Int128* b2 = static_cast<Int128*>(b);
-  *b2 = *b2 + *a2;
+  for (int i = 0; i < *len; ++i) b2[i] = b2[i] + a2[i];
+}
+
+static MPI_Datatype batch_entry_type = MPI_DATATYPE_NULL;
+static MPI_Op batch_op = MPI_OP_NULL;
+
+template <typename T>
+static T reduce_pair(Omega_h_Op op, T a, T b) {
+  switch (op) {
+    case OMEGA_H_MIN:
+      return min2(a, b);
+    case OMEGA_H_MAX:
+      return max2(a, b);
+    case OMEGA_H_SUM:
+      return a + b;
+  }
+  NORETURN(a);
+}
+
+static void mpi_reduce_batch(void* a, void* b, int* len, MPI_Datatype*) {
+  auto a2 = static_cast<AllreduceBatch::Entry*>(a);
+  auto b2 = static_cast<AllreduceBatch::Entry*>(b);
+  for (int i = 0; i < *len; ++i) {
+    auto op = static_cast<Omega_h_Op>(b2[i].op);
+    if (b2[i].is_integer) {
+      b2[i].integer = reduce_pair(op, a2[i].integer, b2[i].integer);
+    } else {
+      b2[i].real = reduce_pair(op, a2[i].real, b2[i].real);
+    }
+  }
+}
+
+static void create_bytes_type(std::size_t bytes, MPI_Datatype* type) {
+  CALL(MPI_Type_contiguous(int(bytes), MPI_BYTE, type));
+  CALL(MPI_Type_commit(type));
+}
+
+void create_mpi_ops() {
+  if (int128_add_op != MPI_OP_NULL) return;
+  create_bytes_type(sizeof(Int128), &int128_type);
+  create_bytes_type(sizeof(AllreduceBatch::Entry), &batch_entry_type);
+  int commute = true;
+  CALL(MPI_Op_create(mpi_add_int128, commute, &int128_add_op));
+  CALL(MPI_Op_create(mpi_reduce_batch, commute, &batch_op));
+}
+
+void free_mpi_ops() {
+  if (int128_add_op == MPI_OP_NULL) return;
+  CALL(MPI_Op_free(&int128_add_op));
+  CALL(MPI_Op_free(&batch_op));
+  CALL(MPI_Type_free(&int128_type));
+  CALL(MPI_Type_free(&batch_entry_type));
 }
 #endif
 
-Int128 Comm::add_int128(Int128 x) const {
+Int AllreduceBatch::add(Real value, Omega_h_Op op) {
+  Entry entry;
+  entry.real = value;
+  entry.integer = 0;
+  entry.op = op;
+  entry.is_integer = 0;
+  entries.push_back(entry);
+  return Int(entries.size() - 1);
+}
+
+Int AllreduceBatch::add(GO value, Omega_h_Op op) {
+  Entry entry;
+  entry.real = 0.0;
+  entry.integer = value;
+  entry.op = op;
+  entry.is_integer = 1;
+  entries.push_back(entry);
+  return Int(entries.size() - 1);
+}
+
+Real AllreduceBatch::get_real(Int slot) const {
+  CHECK(!entries[std::size_t(slot)].is_integer);
+  return entries[std::size_t(slot)].real;
+}
+
+GO AllreduceBatch::get_integer(Int slot) const {
+  CHECK(entries[std::size_t(slot)].is_integer);
+  return entries[std::size_t(slot)].integer;
+}
+
+void Comm::allreduce(AllreduceBatch& batch) const {
+  auto n = int(batch.entries.size());
+  CommRecord record(
+      COMM_ALLREDUCE, sizeof(AllreduceBatch::Entry) * std::size_t(n), 0);
 #ifdef OMEGA_H_USE_MPI
-  MPI_Op op;
-  int commute = true;
-  CALL(MPI_Op_create(mpi_add_int128, commute, &op));
-  CALL(MPI_Allreduce(MPI_IN_PLACE, &x, sizeof(Int128), MPI_PACKED, op, impl_));
-  CALL(MPI_Op_free(&op));
+  CHECK(batch_op != MPI_OP_NULL);
+  CALL(MPI_Allreduce(MPI_IN_PLACE, batch.entries.data(), n, batch_entry_type,
+      batch_op, impl_));
+#else
+  (void)n;
 #endif
+}
+
+Int128 Comm::add_int128(Int128 x) const {
+  add_int128(&x, 1);
   return x;
 }
 
+void Comm::add_int128(Int128 x[], Int n) const {
+  CommRecord record(COMM_ALLREDUCE, sizeof(Int128) * std::size_t(n), 0);
+#ifdef OMEGA_H_USE_MPI
+  CHECK(int128_add_op != MPI_OP_NULL);
+  CALL(MPI_Allreduce(MPI_IN_PLACE, x, n, int128_type, int128_add_op, impl_));
+#else
+  (void)x;
+  (void)n;
+#endif
+}
+
 template <typename T>
 T Comm::exscan(T x, Omega_h_Op op) const {
+  CommRecord record(COMM_EXSCAN, sizeof(T), 0);
 #ifdef OMEGA_H_USE_MPI
   CALL(MPI_Exscan(
       MPI_IN_PLACE, &x, 1, MpiTraits<T>::datatype(), mpi_op(op), impl_));
@@ -216,6 +524,7 @@ T Comm::exscan(T x, Omega_h_Op op) const {
 
 template <typename T>
 void Comm::bcast(T& x) const {
+  CommRecord record(COMM_BCAST, sizeof(T), 0);
 #ifdef OMEGA_H_USE_MPI
   CALL(MPI_Bcast(&x, 1, MpiTraits<T>::datatype(), 0, impl_));
 #else
@@ -228,6 +537,7 @@ void Comm::bcast_string(std::string& s) const {
   I32 len = static_cast<I32>(s.length());
   bcast(len);
   s.resize(static_cast<std::size_t>(len));
+  CommRecord record(COMM_BCAST, s.length(), 0);
   CALL(MPI_Bcast(&s[0], len, MPI_CHAR, 0, impl_));
 #else
   (void)s;
@@ -312,15 +622,16 @@ static int Neighbor_alltoall(HostRead<I32> sources, HostRead<I32> destinations,
 #endif  // end if MPI_VERSION < 3
 }
 
-/* custom implementation of MPI_Neighbor_alltoallv
- * in the case that we are using an MPI older
- * than version 3.0
+/* starts a neighborhood alltoallv. with MPI older than 3.0
+ * there is no MPI_Ineighbor_alltoallv, so one Irecv and one
+ * Isend are posted per neighbor instead
  */
 
-static int Neighbor_alltoallv(HostRead<I32> sources, HostRead<I32> destinations,
-    const void* sendbuf, const int sendcounts[], const int sdispls[],
-    MPI_Datatype sendtype, void* recvbuf, const int recvcounts[],
-    const int rdispls[], MPI_Datatype recvtype, MPI_Comm comm) {
+static void Ineighbor_alltoallv(HostRead<I32> sources,
+    HostRead<I32> destinations, const void* sendbuf, const int sendcounts[],
+    const int sdispls[], MPI_Datatype sendtype, void* recvbuf,
+    const int recvcounts[], const int rdispls[], MPI_Datatype recvtype,
+    MPI_Comm comm, std::vector<MPI_Request>& requests) {
 #if MPI_VERSION < 3
   static int const tag = 42;
   int indegree, outdegree;
@@ -329,26 +640,22 @@ static int Neighbor_alltoallv(HostRead<I32> sources, HostRead<I32> destinations,
   int sendwidth;
   CALL(MPI_Type_size(sendtype, &sendwidth));
   int recvwidth;
-  CALL(MPI_Type_size(sendtype, &recvwidth));
-  MPI_Request* recvreqs = new MPI_Request[indegree];
-  MPI_Request* sendreqs = new MPI_Request[outdegree];
+  CALL(MPI_Type_size(recvtype, &recvwidth));
+  requests.resize(std::size_t(indegree + outdegree));
   for (int i = 0; i < indegree; ++i)
     CALL(MPI_Irecv(static_cast<char*>(recvbuf) + rdispls[i] * recvwidth,
-        recvcounts[i], recvtype, sources[i], tag, comm, recvreqs + i));
-  CALL(MPI_Barrier(comm));
+        recvcounts[i], recvtype, sources[i], tag, comm,
+        &requests[std::size_t(i)]));
   for (int i = 0; i < outdegree; ++i)
     CALL(MPI_Isend(static_cast<char const*>(sendbuf) + sdispls[i] * sendwidth,
-        sendcounts[i], sendtype, destinations[i], tag, comm, sendreqs + i));
-  CALL(MPI_Waitall(outdegree, sendreqs, MPI_STATUSES_IGNORE));
-  delete[] sendreqs;
-  CALL(MPI_Waitall(indegree, recvreqs, MPI_STATUSES_IGNORE));
-  delete[] recvreqs;
-  return MPI_SUCCESS;
+        sendcounts[i], sendtype, destinations[i], tag, comm,
+        &requests[std::size_t(indegree + i)]));
 #else
   (void)sources;
   (void)destinations;
-  return MPI_Neighbor_alltoallv(sendbuf, sendcounts, sdispls, sendtype, recvbuf,
-      recvcounts, rdispls, recvtype, comm);
+  requests.resize(1);
+  CALL(MPI_Ineighbor_alltoallv(sendbuf, sendcounts, sdispls, sendtype, recvbuf,
+      recvcounts, rdispls, recvtype, comm, &requests[0]));
 #endif  // end if MPI_VERSION < 3
 }
 
@@ -356,6 +663,7 @@ static int Neighbor_alltoallv(HostRead<I32> sources, HostRead<I32> destinations,
 
 template <typename T>
 Read<T> Comm::allgather(T x) const {
+  CommRecord record(COMM_ALLGATHER, sizeof(T), dsts_.size());
 #ifdef OMEGA_H_USE_MPI
   HostWrite<T> recvbuf(srcs_.size());
   CALL(Neighbor_allgather(host_srcs_, host_dsts_, &x, 1,
@@ -370,49 +678,103 @@ Read<T> Comm::allgather(T x) const {
 
 template <typename T>
 Read<T> Comm::alltoall(Read<T> x) const {
+  CommRecord record(
+      COMM_ALLTOALL, sizeof(T) * std::size_t(x.size()), dsts_.size());
 #ifdef OMEGA_H_USE_MPI
+#ifdef OMEGA_H_MPI_NEEDS_HOST_COPY
   HostWrite<T> recvbuf(srcs_.size());
   HostRead<T> sendbuf(x);
   CALL(Neighbor_alltoall(host_srcs_, host_dsts_, sendbuf.data(), 1,
       MpiTraits<T>::datatype(), recvbuf.data(), 1, MpiTraits<T>::datatype(),
       impl_));
   return recvbuf.write();
+#else
+  Write<T> recvbuf(srcs_.size());
+  CALL(Neighbor_alltoall(host_srcs_, host_dsts_, x.data(), 1,
+      MpiTraits<T>::datatype(), recvbuf.data(), 1, MpiTraits<T>::datatype(),
+      impl_));
+  return recvbuf;
+#endif
 #else
   return x;
 #endif
 }
 
 template <typename T>
-Read<T> Comm::alltoallv(Read<T> sendbuf_dev, Read<LO> sendcounts_dev,
-    Read<LO> sdispls_dev, Read<LO> recvcounts_dev, Read<LO> rdispls_dev) const {
+Read<T> Comm::alltoallv(Read<T> sendbuf, Read<LO> sendcounts, Read<LO> sdispls,
+    Read<LO> recvcounts, Read<LO> rdispls) const {
+  auto request =
+      ialltoallv(sendbuf, sendcounts, sdispls, recvcounts, rdispls);
+  return wait(request);
+}
+
+template <typename T>
+AlltoallvRequest<T> Comm::ialltoallv(Read<T> sendbuf_dev,
+    Read<LO> sendcounts_dev, Read<LO> sdispls_dev, Read<LO> recvcounts_dev,
+    Read<LO> rdispls_dev) const {
+  CommRecord record(COMM_ALLTOALLV,
+      sizeof(T) * std::size_t(sendbuf_dev.size()), dsts_.size());
+  AlltoallvRequest<T> request;
 #ifdef OMEGA_H_USE_MPI
-  HostRead<T> sendbuf(sendbuf_dev);
-  HostRead<LO> sendcounts(sendcounts_dev);
-  HostRead<LO> recvcounts(recvcounts_dev);
-  HostRead<LO> sdispls(sdispls_dev);
-  HostRead<LO> rdispls(rdispls_dev);
-  CHECK(rdispls.size() == recvcounts.size() + 1);
-  int nrecvd = rdispls.last();
-  HostWrite<T> recvbuf(nrecvd);
-  CHECK(sendcounts.size() == host_dsts_.size());
-  CHECK(recvcounts.size() == host_srcs_.size());
-  CHECK(sdispls.size() == sendcounts.size() + 1);
-  CHECK(sendbuf.size() == sdispls.last());
-  CALL(Neighbor_alltoallv(host_srcs_, host_dsts_, sendbuf.data(),
-      sendcounts.data(), sdispls.data(), MpiTraits<T>::datatype(),
-      recvbuf.data(), recvcounts.data(), rdispls.data(),
-      MpiTraits<T>::datatype(), impl_));
-  return recvbuf.write();
+#ifdef OMEGA_H_MPI_NEEDS_HOST_COPY
+  request.sendbuf = HostRead<T>(sendbuf_dev);
+#else
+  request.sendbuf = sendbuf_dev;
+#endif
+  request.sendcounts = HostRead<LO>(sendcounts_dev);
+  request.recvcounts = HostRead<LO>(recvcounts_dev);
+  request.sdispls = HostRead<LO>(sdispls_dev);
+  request.rdispls = HostRead<LO>(rdispls_dev);
+  CHECK(request.rdispls.size() == request.recvcounts.size() + 1);
+  int nrecvd = request.rdispls.last();
+#ifdef OMEGA_H_MPI_NEEDS_HOST_COPY
+  request.recvbuf = HostWrite<T>(nrecvd);
+#else
+  request.recvbuf = Write<T>(nrecvd);
+#endif
+  CHECK(request.sendcounts.size() == host_dsts_.size());
+  CHECK(request.recvcounts.size() == host_srcs_.size());
+  CHECK(request.sdispls.size() == request.sendcounts.size() + 1);
+  CHECK(request.sendbuf.size() == request.sdispls.last());
+  auto self = rank();
+  for (LO i = 0; i < host_dsts_.size(); ++i) {
+    if (host_dsts_[i] != self && request.sendcounts[i]) ++messages_sent;
+  }
+  Ineighbor_alltoallv(host_srcs_, host_dsts_, request.sendbuf.data(),
+      request.sendcounts.data(), request.sdispls.data(),
+      MpiTraits<T>::datatype(), request.recvbuf.data(),
+      request.recvcounts.data(), request.rdispls.data(),
+      MpiTraits<T>::datatype(), impl_, request.requests);
 #else
   (void)sendcounts_dev;
   (void)recvcounts_dev;
   (void)sdispls_dev;
   (void)rdispls_dev;
-  return sendbuf_dev;
+  request.result = sendbuf_dev;
+#endif
+  return request;
+}
+
+template <typename T>
+Read<T> Comm::wait(AlltoallvRequest<T>& request) const {
+  CommRecord record(COMM_ALLTOALLV, 0, 0, false);
+#ifdef OMEGA_H_USE_MPI
+  if (!request.result.exists()) {
+    CALL(MPI_Waitall(int(request.requests.size()), request.requests.data(),
+        MPI_STATUSES_IGNORE));
+    request.requests.clear();
+#ifdef OMEGA_H_MPI_NEEDS_HOST_COPY
+    request.result = request.recvbuf.write();
+#else
+    request.result = request.recvbuf;
+#endif
+  }
 #endif
+  return request.result;
 }
 
 void Comm::barrier() const {
+  CommRecord record(COMM_BARRIER, 0, 0);
 #ifdef OMEGA_H_USE_MPI
   CALL(MPI_Barrier(impl_));
 #endif
@@ -422,12 +784,19 @@ void Comm::barrier() const {
 
 #define INST(T)                                                                \
   template T Comm::allreduce(T x, Omega_h_Op op) const;                        \
+  template void Comm::allreduce(T x[], Int n, Omega_h_Op op) const;            \
   template T Comm::exscan(T x, Omega_h_Op op) const;                           \
   template void Comm::bcast(T& x) const;                                       \
   template Read<T> Comm::allgather(T x) const;                                 \
   template Read<T> Comm::alltoall(Read<T> x) const;                            \
   template Read<T> Comm::alltoallv(Read<T> sendbuf, Read<LO> sendcounts,       \
-      Read<LO> sdispls, Read<LO> recvcounts, Read<LO> rdispls) const;
+      Read<LO> sdispls, Read<LO> recvcounts, Read<LO> rdispls) const;          \
+  template AlltoallvRequest<T> Comm::ialltoallv(Read<T> sendbuf,               \
+      Read<LO> sendcounts, Read<LO> sdispls, Read<LO> recvcounts,              \
+      Read<LO> rdispls) const;                                                 \
+  template Read<T> Comm::wait(AlltoallvRequest<T> & request) const;           \
+  template AllreduceRequest<T> Comm::iallreduce(T x, Omega_h_Op op) const;     \
+  template T Comm::wait(AllreduceRequest<T> & request) const;
 INST(I8)
 INST(I32)
 INST(I64)
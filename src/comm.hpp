@@ -69,6 +69,12 @@ inline MPI_Op mpi_op(Omega_h_Op op) {
   };
   NORETURN(MPI_MIN);
 }
+
+/* the datatypes and operations used by Comm::add_int128 and
+   by batched allreduces. they are created once by
+   Omega_h_init and freed by Omega_h_finalize */
+void create_mpi_ops();
+void free_mpi_ops();
 #endif
 
 }  // end namespace Omega_h
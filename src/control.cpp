@@ -32,6 +32,7 @@ extern "C" void Omega_h_init_internal(
     CHECK(MPI_SUCCESS == MPI_Init(argc, argv));
     we_called_mpi_init = true;
   }
+  create_mpi_ops();
 #endif
 #ifdef OMEGA_H_USE_KOKKOS
   if (!Kokkos::DefaultExecutionSpace::is_initialized()) {
@@ -68,7 +69,11 @@ extern "C" void Omega_h_finalize(void) {
 #ifdef OMEGA_H_USE_MPI
   }
 #endif
+  trim_pool();
 #ifdef OMEGA_H_USE_MPI
+  int mpi_is_finalized;
+  CHECK(MPI_SUCCESS == MPI_Finalized(&mpi_is_finalized));
+  if (!mpi_is_finalized) free_mpi_ops();
   if (we_called_mpi_init) {
     CHECK(MPI_SUCCESS == MPI_Finalize());
     we_called_mpi_init = false;
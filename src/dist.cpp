@@ -8,7 +8,29 @@
 
 namespace Omega_h {
 
-Dist::Dist() {}
+static bool node_aware = false;
+static I32 node_size = 0;
+
+void set_node_aware_exchanges(bool enabled, I32 ranks_per_node) {
+  node_aware = enabled;
+  node_size = ranks_per_node;
+}
+
+bool node_aware_exchanges() { return node_aware; }
+
+/* a node-aware exchange runs in two stages: to_nodes sends
+   each item either straight to its destination on this node
+   or to the leader of the destination's node, and
+   within_nodes forwards items to their destinations from
+   there. arrivals2slots places the forwarded items where a
+   direct exchange would have put them */
+struct Dist::Hierarchy {
+  Dist to_nodes;
+  Dist within_nodes;
+  LOs arrivals2slots;
+};
+
+Dist::Dist() : is_stage_(false) { forget_cache(); }
 
 Dist::Dist(Dist const& other) { copy(other); }
 
@@ -17,7 +39,9 @@ Dist& Dist::operator=(Dist const& other) {
   return *this;
 }
 
-Dist::Dist(CommPtr comm, Remotes fitems2rroots, LO nrroots) {
+Dist::Dist(CommPtr comm, Remotes fitems2rroots, LO nrroots)
+    : is_stage_(false) {
+  forget_cache();
   set_parent_comm(comm);
   set_dest_ranks(fitems2rroots.ranks);
   set_dest_idxs(fitems2rroots.idxs, nrroots);
@@ -60,20 +84,32 @@ void Dist::set_dest_ranks(Read<I32> items2ranks) {
   auto fdegrees = get_degrees(msgs2content_[F]);
   auto rdegrees = comm_[F]->alltoall(fdegrees);
   msgs2content_[R] = offset_scan(rdegrees);
+  forget_cache();
 }
 
+/* the exchange here is always direct, so that only Dists
+   which go on to exchange data build a node hierarchy */
 void Dist::set_dest_idxs(LOs fitems2rroots, LO nrroots) {
-  auto rcontent2rroots = exch(fitems2rroots, 1);
+  auto plan = ask_plan(1);
+  auto rcontent2rroots =
+      comm_[F]->alltoallv(permute(fitems2rroots, items2content_[F], 1),
+          plan.sendcounts, plan.sdispls, plan.recvcounts, plan.rdispls);
   auto rroots2rcontent = invert_map_by_sorting(rcontent2rroots, nrroots);
   roots2items_[R] = rroots2rcontent.a2ab;
   items2content_[R] = rroots2rcontent.ab2b;
+  forget_inverse();
 }
 
 void Dist::set_roots2items(LOs froots2fitems) {
   roots2items_[F] = froots2fitems;
+  forget_inverse();
 }
 
+/* the inverse is computed once and kept in the cache, so
+   that repeated calls (e.g. Mesh::sync_array) also reuse
+   the inverse's own exchange plans */
 Dist Dist::invert() const {
+  if (cache_->inverse) return *(cache_->inverse);
   Dist out;
   out.parent_comm_ = parent_comm_;
   for (Int i = 0; i < 2; ++i) {
@@ -82,24 +118,93 @@ Dist Dist::invert() const {
     out.msgs2content_[i] = msgs2content_[1 - i];
     out.comm_[i] = comm_[1 - i];
   }
+  cache_->inverse = std::make_shared<Dist>(out);
   return out;
 }
 
+Dist::Plan Dist::ask_plan(Int width) const {
+  for (auto& plan : cache_->plans) {
+    if (plan.width == width) return plan;
+  }
+  Plan plan;
+  plan.width = width;
+  plan.sendcounts = multiply_each_by(width, get_degrees(msgs2content_[F]));
+  plan.recvcounts = multiply_each_by(width, get_degrees(msgs2content_[R]));
+  plan.sdispls = offset_scan(plan.sendcounts);
+  plan.rdispls = offset_scan(plan.recvcounts);
+  cache_->plans.push_back(plan);
+  return plan;
+}
+
+Dist::Hierarchy const& Dist::ask_hierarchy() const {
+  if (cache_->hierarchy) return *(cache_->hierarchy);
+  auto leader = parent_comm_->rank();
+  parent_comm_->node_comm(node_size)->bcast(leader);
+  auto msgs2leaders = comm_[R]->allgather(leader);
+  auto content2msgs = invert_fan(msgs2content_[F]);
+  auto content2ranks = unmap(content2msgs, msgs2ranks(), 1);
+  auto content2leaders = unmap(content2msgs, msgs2leaders, 1);
+  /* ask each destination where a direct exchange would have
+     put our items in its receive buffer */
+  auto plan = ask_plan(1);
+  auto content2slots = comm_[R]->alltoallv(LOs(plan.rdispls.last(), 0, 1),
+      plan.recvcounts, plan.rdispls, plan.sendcounts, plan.sdispls);
+  auto ncontent = content2msgs.size();
+  Write<I32> content2mids(ncontent);
+  auto choose_mid = LAMBDA(LO c) {
+    content2mids[c] =
+        (content2leaders[c] == leader) ? content2ranks[c] : content2leaders[c];
+  };
+  parallel_for(ncontent, choose_mid);
+  auto h = std::make_shared<Hierarchy>();
+  h->to_nodes.is_stage_ = true;
+  h->to_nodes.set_parent_comm(parent_comm_);
+  h->to_nodes.set_dest_ranks(content2mids);
+  auto mids2ranks = h->to_nodes.exch(content2ranks, 1);
+  auto mids2slots = h->to_nodes.exch(content2slots, 1);
+  h->within_nodes.is_stage_ = true;
+  h->within_nodes.set_parent_comm(parent_comm_);
+  h->within_nodes.set_dest_ranks(mids2ranks);
+  h->arrivals2slots = h->within_nodes.exch(mids2slots, 1);
+  cache_->hierarchy = h;
+  return *h;
+}
+
 template <typename T>
 Read<T> Dist::exch(Read<T> data, Int width) const {
+  auto exchange = exch_start(data, width);
+  return exch_finish(exchange);
+}
+
+template <typename T>
+DistExchange<T> Dist::exch_start(Read<T> data, Int width) const {
   if (roots2items_[F].exists()) {
     data = expand(data, roots2items_[F], width);
   }
   if (items2content_[F].exists()) {
     data = permute(data, items2content_[F], width);
   }
-  auto sendcounts = multiply_each_by(width, get_degrees(msgs2content_[F]));
-  auto recvcounts = multiply_each_by(width, get_degrees(msgs2content_[R]));
-  auto sdispls = offset_scan(sendcounts);
-  auto rdispls = offset_scan(recvcounts);
-  data = comm_[F]->alltoallv(data, sendcounts, sdispls, recvcounts, rdispls);
-  if (items2content_[R].exists()) {
-    data = unmap(items2content_[R], data, width);
+  DistExchange<T> exchange;
+  if (node_aware && !is_stage_ && parent_comm_->size() > 1) {
+    auto& h = ask_hierarchy();
+    auto mid_data = h.to_nodes.exch(data, width);
+    auto arrived = h.within_nodes.exch(mid_data, width);
+    exchange.request.result = permute(arrived, h.arrivals2slots, width);
+  } else {
+    auto plan = ask_plan(width);
+    exchange.request = comm_[F]->ialltoallv(data, plan.sendcounts,
+        plan.sdispls, plan.recvcounts, plan.rdispls);
+  }
+  exchange.items2content = items2content_[R];
+  exchange.width = width;
+  return exchange;
+}
+
+template <typename T>
+Read<T> Dist::exch_finish(DistExchange<T>& exchange) const {
+  auto data = comm_[F]->wait(exchange.request);
+  if (exchange.items2content.exists()) {
+    data = unmap(exchange.items2content, data, exchange.width);
   }
   return data;
 }
@@ -162,6 +267,8 @@ void Dist::change_comm(CommPtr new_comm) {
   comm_[R] = comm_[F]->graph_inverse();
   // replace parent_comm_
   parent_comm_ = new_comm;
+  // the cached inverse still refers to the old graph comms
+  forget_cache();
   // thats it! since all rank information is queried from graph comms
 }
 
@@ -179,10 +286,24 @@ void Dist::copy(Dist const& other) {
     msgs2content_[i] = other.msgs2content_[i];
     comm_[i] = other.comm_[i];
   }
+  cache_ = other.cache_;
+  is_stage_ = other.is_stage_;
+}
+
+void Dist::forget_cache() { cache_ = std::make_shared<Cache>(); }
+
+/* copies of this Dist share the cache, so it is forked
+   rather than edited in place */
+void Dist::forget_inverse() {
+  auto kept = std::make_shared<Cache>(*cache_);
+  kept->inverse.reset();
+  cache_ = kept;
 }
 
 #define INST_T(T)                                                              \
   template Read<T> Dist::exch(Read<T> data, Int width) const;                  \
+  template DistExchange<T> Dist::exch_start(Read<T> data, Int width) const;    \
+  template Read<T> Dist::exch_finish(DistExchange<T> & exchange) const;        \
   template Read<T> Dist::exch_reduce(Read<T> data, Int width, Omega_h_Op op)   \
       const;
 INST_T(I8)
@@ -1,9 +1,14 @@
 #include "ghost.hpp"
 
+#include <iostream>
+
+#include "array.hpp"
 #include "loop.hpp"
 #include "map.hpp"
 #include "migrate.hpp"
+#include "owners.hpp"
 #include "remotes.hpp"
+#include "unmap_mesh.hpp"
 
 namespace Omega_h {
 
@@ -128,13 +133,61 @@ void partition_by_verts(Mesh* mesh, bool verbose) {
   *mesh = new_mesh;
 }
 
+/* every element has its owned copy on the owning rank, so element-based
+ * partitioning is reached locally by keeping the owned elements and their
+ * boundaries. only ownership of the remaining lower entities needs
+ * communication, and it is decided among the remaining copies the same way
+ * migrate_mesh() decides it.
+ */
 void partition_by_elems(Mesh* mesh, bool verbose) {
+  auto comm = mesh->comm();
   auto dim = mesh->dim();
-  auto all2owners = mesh->ask_owners(dim);
-  auto marked_owned = mesh->owned(dim);
-  auto owned2all = collect_marked(marked_owned);
-  auto owned2owners = unmap(owned2all, all2owners);
-  migrate_mesh(mesh, owned2owners, verbose);
+  auto elems_are_owned = mesh->owned(dim);
+  if (verbose) {
+    auto nelems = comm->allreduce(GO(mesh->nelems()), OMEGA_H_SUM);
+    auto nowned = sum(comm, elems_are_owned);
+    if (comm->rank() == 0) {
+      std::cout << "unghosting keeps (" << nowned << ") / (" << nelems
+                << " total) elements\n";
+    }
+  }
+  auto new_mesh = mesh->copy_meta();
+  LOs old_lows2new_lows;
+  for (Int ent_dim = VERT; ent_dim <= dim; ++ent_dim) {
+    auto keep = elems_are_owned;
+    if (ent_dim < dim) {
+      auto ents2elems = mesh->ask_up(ent_dim, dim);
+      auto ents2ent_elems = ents2elems.a2ab;
+      auto ent_elems2elems = ents2elems.ab2b;
+      Write<I8> keep_w(mesh->nents(ent_dim));
+      auto f = LAMBDA(LO ent) {
+        I8 k = 0;
+        for (auto ee = ents2ent_elems[ent]; ee < ents2ent_elems[ent + 1];
+             ++ee) {
+          k = k || elems_are_owned[ent_elems2elems[ee]];
+        }
+        keep_w[ent] = k;
+      };
+      parallel_for(mesh->nents(ent_dim), f);
+      keep = keep_w;
+    }
+    auto new_ents2old_ents = collect_marked(keep);
+    if (ent_dim == VERT) {
+      new_mesh.set_verts(new_ents2old_ents.size());
+    } else {
+      unmap_down(
+          mesh, &new_mesh, ent_dim, new_ents2old_ents, old_lows2new_lows);
+    }
+    unmap_tags(mesh, &new_mesh, ent_dim, new_ents2old_ents);
+    auto new_ents2old_owners =
+        unmap(new_ents2old_ents, mesh->ask_owners(ent_dim));
+    auto owners = update_ownership(
+        Dist(comm, new_ents2old_owners, mesh->nents(ent_dim)), Read<I32>());
+    new_mesh.set_owners(ent_dim, owners);
+    old_lows2new_lows =
+        invert_injective_map(new_ents2old_ents, mesh->nents(ent_dim));
+  }
+  *mesh = new_mesh;
 }
 
 }  // end namespace Omega_h
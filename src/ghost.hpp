@@ -22,6 +22,10 @@ void get_own_verts2own_elem_uses(
     Mesh* mesh, Remotes& serv_uses2own_elems, LOs& own_verts2serv_uses);
 Remotes push_elem_uses(RemoteGraph own_verts2own_elems, Dist own_verts2verts);
 
+/* TODO: ghost_mesh rebuilds the ghost layers from the element-based
+   mesh every time. updating them incrementally across cavity
+   modifications would need those modifications to understand
+   ghosted ownership. only unghosting (partition_by_elems) is local */
 void ghost_mesh(Mesh* mesh, Int nlayers, bool verbose);
 void partition_by_verts(Mesh* mesh, bool verbose);
 void partition_by_elems(Mesh* mesh, bool verbose);
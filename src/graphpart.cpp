@@ -0,0 +1,253 @@
+#include "graphpart.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "array.hpp"
+#include "loop.hpp"
+#include "map.hpp"
+#include "sort.hpp"
+
+namespace Omega_h {
+
+/* for each owned element, find the part it shares the most sides
+   with among the parts it may move to in this pass, and how many
+   more sides that is than it shares with its own part.
+   moves go to higher parts on upward passes and to lower parts
+   otherwise, so two neighbors never trade places in one pass.
+   an element may only move to this rank's part or to the part of
+   a rank that owns one of its neighbors, so that all the parts a
+   rank deals with are those of its neighbor ranks */
+static void find_moves(Mesh* mesh, Read<I32> parts, bool upward,
+    Write<I32> dests, Write<I32> gains) {
+  auto dual = mesh->ask_dual();
+  auto elems2elem_elems = dual.a2ab;
+  auto elem_elems2elems = dual.ab2b;
+  auto owned = mesh->owned(mesh->dim());
+  auto owner_ranks = mesh->ask_owners(mesh->dim()).ranks;
+  auto rank = mesh->comm()->rank();
+  auto f = LAMBDA(LO e) {
+    dests[e] = -1;
+    gains[e] = 0;
+    if (!owned[e]) return;
+    auto begin = elems2elem_elems[e];
+    auto end = elems2elem_elems[e + 1];
+    auto p = parts[e];
+    I32 nsame = 0;
+    for (auto ee = begin; ee < end; ++ee) {
+      nsame += (parts[elem_elems2elems[ee]] == p);
+    }
+    I32 best = -1;
+    I32 nbest = 0;
+    for (auto ee = begin; ee < end; ++ee) {
+      auto q = parts[elem_elems2elems[ee]];
+      if (q == p || ((q > p) != upward)) continue;
+      I32 nq = 0;
+      bool reachable = (q == rank);
+      for (auto ee2 = begin; ee2 < end; ++ee2) {
+        auto e2 = elem_elems2elems[ee2];
+        nq += (parts[e2] == q);
+        reachable = reachable || (owner_ranks[e2] == q);
+      }
+      if (!reachable) continue;
+      if (nq > nbest || (nq == nbest && q < best)) {
+        best = q;
+        nbest = nq;
+      }
+    }
+    if (nbest > nsame) {
+      dests[e] = best;
+      gains[e] = nbest - nsame;
+    }
+  };
+  parallel_for(mesh->nelems(), f);
+}
+
+/* finds a neighbor index for each part in (parts),
+   or -1 for this rank's own part */
+static std::vector<Int> find_neighbors(
+    HostRead<I32> parts, HostRead<I32> neighbors, I32 rank) {
+  std::vector<Int> out(std::size_t(parts.size()));
+  auto first = neighbors.data();
+  auto last = first + neighbors.size();
+  for (LO i = 0; i < parts.size(); ++i) {
+    if (parts[i] == rank) {
+      out[std::size_t(i)] = -1;
+      continue;
+    }
+    auto it = std::lower_bound(first, last, parts[i]);
+    CHECK(it != last && *it == parts[i]);
+    out[std::size_t(i)] = Int(it - first);
+  }
+  return out;
+}
+
+/* runs refinement passes on a ghosted mesh, where every owned
+   element can see the parts of all its neighbors.
+   each rank only keeps the mass of its own part. the masses
+   wanted by and moved into a part are sent to its rank over
+   a graph of neighbor ranks, so no pass costs O(nparts).
+   returns the new part of each element */
+static Read<I32> refine_parts(Mesh* mesh, Reals masses, Real max_imbalance) {
+  Int const max_passes = 16;
+  auto comm = mesh->comm();
+  auto rank = comm->rank();
+  auto dim = mesh->dim();
+  auto owners = mesh->ask_owners(dim);
+  auto parts = owners.ranks;
+  /* the ranks owning ghost elements are the only ones whose
+     parts this rank's elements can move to or from */
+  auto ghosts = collect_marked(invert_marks(mesh->owned(dim)));
+  Dist ghosts2ranks;
+  ghosts2ranks.set_parent_comm(comm);
+  ghosts2ranks.set_dest_ranks(unmap(ghosts, owners.ranks, 1));
+  auto to_neighbors = ghosts2ranks.comm();
+  auto from_neighbors = to_neighbors->graph_inverse();
+  auto neighbors = HostRead<I32>(to_neighbors->destinations());
+  auto nneighbors = neighbors.size();
+  auto nsources = to_neighbors->sources().size();
+  auto part_mass = sum(mesh->owned_array(dim, masses, 1));
+  auto total_mass = comm->allreduce(part_mass, OMEGA_H_SUM);
+  auto max_mass = max_imbalance * total_mass / Real(comm->size());
+  Int nidle = 0;
+  for (Int pass = 0; pass < max_passes && nidle < 2; ++pass) {
+    Write<I32> dests(mesh->nelems());
+    Write<I32> gains(mesh->nelems());
+    find_moves(mesh, parts, (pass % 2 == 0), dests, gains);
+    /* candidates with the highest gains get the room first */
+    auto cands = collect_marked(each_neq_to(Read<I32>(dests), -1));
+    auto cand_gains = unmap(cands, Read<I32>(gains), 1);
+    auto order = sort_by_keys(multiply_each_by(-1, cand_gains));
+    auto sorted = unmap(order, cands, 1);
+    auto ncands = sorted.size();
+    auto sorted_h = HostRead<LO>(sorted);
+    auto dests_h = HostRead<I32>(unmap(sorted, Read<I32>(dests), 1));
+    auto masses_h = HostRead<Real>(unmap(sorted, masses, 1));
+    auto to = find_neighbors(dests_h, neighbors, rank);
+    auto from = find_neighbors(HostRead<I32>(unmap(sorted, parts, 1)),
+        neighbors, rank);
+    /* a part without enough room takes the same fraction of
+       what each rank wants to send it */
+    HostWrite<Real> wanted(nneighbors);
+    for (Int n = 0; n < nneighbors; ++n) wanted[n] = 0.0;
+    Real wanted_here = 0.0;
+    for (LO c = 0; c < ncands; ++c) {
+      auto n = to[std::size_t(c)];
+      if (n == -1) {
+        wanted_here += masses_h[c];
+      } else {
+        wanted[n] += masses_h[c];
+      }
+    }
+    auto wanted_from = to_neighbors->alltoall(Read<Real>(wanted.write()));
+    auto total_wanted = wanted_here + sum(wanted_from);
+    Real fraction_here = 1.0;
+    if (total_wanted != 0.0) {
+      auto room = max_mass - part_mass;
+      fraction_here = max2(0.0, min2(1.0, room / total_wanted));
+    }
+    auto fractions = HostRead<Real>(
+        from_neighbors->alltoall(Reals(nsources, fraction_here)));
+    wanted_here *= fraction_here;
+    for (Int n = 0; n < nneighbors; ++n) wanted[n] *= fractions[n];
+    HostWrite<Real> changes(nneighbors);
+    for (Int n = 0; n < nneighbors; ++n) changes[n] = 0.0;
+    Real change_here = 0.0;
+    std::vector<LO> moved;
+    std::vector<I32> moved_dests;
+    for (LO c = 0; c < ncands; ++c) {
+      auto n = to[std::size_t(c)];
+      auto m = masses_h[c];
+      auto fraction = (n == -1) ? fraction_here : fractions[n];
+      auto& room = (n == -1) ? wanted_here : wanted[n];
+      if (fraction < 1.0) {
+        if (m > room) continue;
+        room -= m;
+      }
+      auto n_from = from[std::size_t(c)];
+      if (n_from == -1) {
+        change_here -= m;
+      } else {
+        changes[n_from] -= m;
+      }
+      if (n == -1) {
+        change_here += m;
+      } else {
+        changes[n] += m;
+      }
+      moved.push_back(sorted_h[c]);
+      moved_dests.push_back(dests_h[c]);
+    }
+    auto changes_from = to_neighbors->alltoall(Read<Real>(changes.write()));
+    part_mass += change_here + sum(changes_from);
+    auto nmoved = LO(moved.size());
+    auto nmoves = comm->allreduce(GO(nmoved), OMEGA_H_SUM);
+    nidle = (nmoves == 0) ? (nidle + 1) : 0;
+    HostWrite<LO> moved_h(nmoved);
+    HostWrite<I32> moved_dests_h(nmoved);
+    for (LO i = 0; i < nmoved; ++i) {
+      moved_h[i] = moved[std::size_t(i)];
+      moved_dests_h[i] = moved_dests[std::size_t(i)];
+    }
+    auto new_parts = deep_copy(parts);
+    map_into(Read<I32>(moved_dests_h.write()), LOs(moved_h.write()),
+        new_parts, 1);
+    parts = mesh->sync_array(dim, Read<I32>(new_parts), 1);
+  }
+  return parts;
+}
+
+void refine_graph_partition(Mesh* mesh, Reals masses, Real max_imbalance) {
+  auto comm = mesh->comm();
+  if (comm->size() == 1) return;
+  auto dim = mesh->dim();
+  CHECK(mesh->parting() == OMEGA_H_ELEM_BASED);
+  /* the masses and the new parts ride along as tags while
+     the ghost layer is added and removed */
+  mesh->add_tag(dim, "graph_part_mass", 1, OMEGA_H_DONT_TRANSFER,
+      OMEGA_H_DONT_OUTPUT, masses);
+  mesh->set_parting(OMEGA_H_GHOSTED);
+  auto parts = refine_parts(
+      mesh, mesh->get_array<Real>(dim, "graph_part_mass"), max_imbalance);
+  mesh->add_tag(
+      dim, "graph_part", 1, OMEGA_H_DONT_TRANSFER, OMEGA_H_DONT_OUTPUT, parts);
+  mesh->set_parting(OMEGA_H_ELEM_BASED);
+  parts = mesh->get_array<I32>(dim, "graph_part");
+  mesh->remove_tag(dim, "graph_part");
+  mesh->remove_tag(dim, "graph_part_mass");
+  auto nelems = mesh->nelems();
+  Dist elems2parts;
+  elems2parts.set_parent_comm(comm);
+  elems2parts.set_dest_ranks(parts);
+  auto elems2owners =
+      Remotes(Read<I32>(nelems, comm->rank()), LOs(nelems, 0, 1));
+  mesh->migrate(elems2parts.exch(elems2owners, 1));
+}
+
+PartitionStats get_partition_stats(Mesh* mesh, Reals masses) {
+  CHECK(mesh->parting() == OMEGA_H_ELEM_BASED);
+  auto comm = mesh->comm();
+  auto side_dim = mesh->dim() - 1;
+  /* with element-based partitioning, a side has one
+     copy on each rank that has an element adjacent to it */
+  AllreduceBatch batch;
+  auto copies_slot = batch.add(GO(mesh->nents(side_dim)), OMEGA_H_SUM);
+  auto sides_slot = batch.add(GO(sum(mesh->owned(side_dim))), OMEGA_H_SUM);
+  auto elems_slot = batch.add(GO(mesh->nelems()), OMEGA_H_SUM);
+  auto max_elems_slot = batch.add(GO(mesh->nelems()), OMEGA_H_MAX);
+  if (!masses.exists()) masses = Reals(mesh->nelems(), 1.0);
+  auto mass = sum(masses);
+  auto mass_slot = batch.add(mass, OMEGA_H_SUM);
+  auto max_mass_slot = batch.add(mass, OMEGA_H_MAX);
+  comm->allreduce(batch);
+  PartitionStats stats;
+  stats.cut_sides =
+      batch.get_integer(copies_slot) - batch.get_integer(sides_slot);
+  auto avg_elems = Real(batch.get_integer(elems_slot)) / Real(comm->size());
+  stats.imbalance = Real(batch.get_integer(max_elems_slot)) / avg_elems;
+  auto avg_mass = batch.get_real(mass_slot) / Real(comm->size());
+  stats.mass_imbalance = batch.get_real(max_mass_slot) / avg_mass;
+  return stats;
+}
+
+}  // end namespace Omega_h
@@ -0,0 +1,23 @@
+#ifndef GRAPHPART_HPP
+#define GRAPHPART_HPP
+
+#include "internal.hpp"
+
+namespace Omega_h {
+
+/* improves the element-based partitioning of a mesh by moving
+   elements across part boundaries so that fewer sides are
+   shared between parts. this is a greedy sweep over the dual
+   graph: an owned element only moves when that strictly lowers
+   the number of sides it shares with other parts, and there are
+   no negative-gain moves or rollback as in Kernighan-Lin or
+   Fiduccia-Mattheyses, so it stops at a local minimum.
+   masses are the element weights, and no part is allowed to
+   grow beyond max_imbalance times the average part mass.
+   the existing partitioning (e.g. from RIB) is the starting point */
+
+void refine_graph_partition(Mesh* mesh, Reals masses, Real max_imbalance);
+
+}  // end namespace Omega_h
+
+#endif
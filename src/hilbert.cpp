@@ -8,6 +8,35 @@ namespace Omega_h {
 
 namespace hilbert {
 
+/* floating-point coordinates to the transposed Hilbert
+   index on a grid of 2^(nbits) points per axis */
+template <Int dim>
+INLINE void coords_to_transpose(Reals const& coords, LO i,
+    BBox<dim> const& bbox, Real maxl, Int nbits, hilbert::coord_t X[]) {
+  for (Int j = 0; j < dim; ++j) {
+    /* floating-point coordinate to fine-grid integer coordinate,
+       should be non-negative since we subtract the BBox min */
+    Real coord = coords[i * dim + j];
+    Real zero_to_one_coord = (coord - bbox.min[j]) / maxl;
+    Real zero_to_2eP_coord = zero_to_one_coord * exp2(Real(nbits));
+    X[j] = hilbert::coord_t(zero_to_2eP_coord);
+    /* some values will just graze the acceptable range
+       (with proper floating point math they are exactly
+        equal to 2^(nbits), and we'll be safe with (>=) in case
+       floating point math is even worse than that. */
+    if (X[j] >= (hilbert::coord_t(1) << nbits))
+      X[j] = (hilbert::coord_t(1) << nbits) - 1;
+  }
+  hilbert::AxestoTranspose(X, nbits, dim);
+}
+
+template <Int dim>
+static Real max_extent(BBox<dim> bbox) {
+  Real maxl = 0;
+  for (Int i = 0; i < dim; ++i) maxl = max2(maxl, bbox.max[i] - bbox.min[i]);
+  return maxl;
+}
+
 /* for each set of (dim) floating-point coordinates, this function
    outputs a set of (dim) 64-bit integers which represent the
    closest point of a fine-grid Hilbert curve to the coordinates.
@@ -23,28 +52,13 @@ namespace hilbert {
 template <Int dim>
 static Read<I64> dists_from_coords_dim(Reals coords) {
   auto bbox = find_bounding_box<dim>(coords);
-  Real maxl = 0;
-  for (Int i = 0; i < dim; ++i) maxl = max2(maxl, bbox.max[i] - bbox.min[i]);
+  auto maxl = max_extent(bbox);
   LO npts = coords.size() / dim;
   Write<I64> out(npts * dim);
   auto f = LAMBDA(LO i) {
     hilbert::coord_t X[dim];
     Int nbits = MANTISSA_BITS;
-    for (Int j = 0; j < dim; ++j) {
-      /* floating-point coordinate to fine-grid integer coordinate,
-         should be non-negative since we subtract the BBox min */
-      Real coord = coords[i * dim + j];
-      Real zero_to_one_coord = (coord - bbox.min[j]) / maxl;
-      Real zero_to_2eP_coord = zero_to_one_coord * exp2(Real(nbits));
-      X[j] = hilbert::coord_t(zero_to_2eP_coord);
-      /* some values will just graze the acceptable range
-         (with proper floating point math they are exactly
-          equal to 2^(nbits), and we'll be safe with (>=) in case
-         floating point math is even worse than that. */
-      if (X[j] >= (hilbert::coord_t(1) << nbits))
-        X[j] = (hilbert::coord_t(1) << nbits) - 1;
-    }
-    hilbert::AxestoTranspose(X, nbits, dim);
+    coords_to_transpose<dim>(coords, i, bbox, maxl, nbits, X);
     hilbert::coord_t Y[dim];
     hilbert::untranspose(X, Y, nbits, dim);
     for (Int j = 0; j < dim; ++j) /* this cast *should* be safe... */
@@ -54,17 +68,96 @@ static Read<I64> dists_from_coords_dim(Reals coords) {
   return out;
 }
 
-static Read<I64> dists_from_coords(Reals coords, Int dim) {
+Read<I64> dists_from_coords(Reals coords, Int dim) {
   if (dim == 3) return dists_from_coords_dim<3>(coords);
   if (dim == 2) return dists_from_coords_dim<2>(coords);
   NORETURN(Read<I64>());
 }
 
+template <Int dim>
+static Read<I64> packed_dists_from_coords_dim(
+    Reals coords, BBox<dim> bbox, Int nbits) {
+  auto maxl = max_extent(bbox);
+  auto axis_bits = get_axis_bits(dim, nbits);
+  auto nwords = get_packed_width(dim, nbits);
+  LO npts = coords.size() / dim;
+  Write<I64> out(npts * nwords);
+  auto f = LAMBDA(LO i) {
+    hilbert::coord_t X[dim];
+    coords_to_transpose<dim>(coords, i, bbox, maxl, axis_bits, X);
+    hilbert::coord_t Y[dim];
+    hilbert::transpose_to_words(X, Y, axis_bits, dim);
+    for (Int j = 0; j < nwords; ++j) {
+      out[i * nwords + j] = static_cast<I64>(Y[j]);
+    }
+  };
+  parallel_for(npts, f);
+  return out;
+}
+
+Read<I64> packed_dists_from_coords(Reals coords, Int dim, Int nbits) {
+  if (dim == 3) {
+    auto bbox = find_bounding_box<3>(coords);
+    return packed_dists_from_coords_dim<3>(coords, bbox, nbits);
+  }
+  if (dim == 2) {
+    auto bbox = find_bounding_box<2>(coords);
+    return packed_dists_from_coords_dim<2>(coords, bbox, nbits);
+  }
+  NORETURN(Read<I64>());
+}
+
+/* the union of the bounding boxes of all ranks,
+   found with one reduction by negating the maxima */
+template <Int dim>
+static BBox<dim> find_global_bounding_box(CommPtr comm, Reals coords) {
+  auto bbox = find_bounding_box<dim>(coords);
+  Real bounds[dim * 2];
+  for (Int i = 0; i < dim; ++i) {
+    bounds[i] = bbox.min[i];
+    bounds[dim + i] = -bbox.max[i];
+  }
+  comm->allreduce(bounds, dim * 2, OMEGA_H_MIN);
+  for (Int i = 0; i < dim; ++i) {
+    bbox.min[i] = bounds[i];
+    bbox.max[i] = -bounds[dim + i];
+  }
+  return bbox;
+}
+
+Read<I64> packed_dists_from_coords(
+    CommPtr comm, Reals coords, Int dim, Int nbits) {
+  if (dim == 3) {
+    auto bbox = find_global_bounding_box<3>(comm, coords);
+    return packed_dists_from_coords_dim<3>(coords, bbox, nbits);
+  }
+  if (dim == 2) {
+    auto bbox = find_global_bounding_box<2>(comm, coords);
+    return packed_dists_from_coords_dim<2>(coords, bbox, nbits);
+  }
+  NORETURN(Read<I64>());
+}
+
+Int get_axis_bits(Int dim, Int nbits) {
+  CHECK(nbits >= dim);
+  return min2(nbits / dim, Int(MANTISSA_BITS));
+}
+
+Int get_packed_width(Int dim, Int nbits) {
+  auto total_bits = get_axis_bits(dim, nbits) * dim;
+  return (total_bits + word_bits - 1) / word_bits;
+}
+
 LOs sort_coords(Reals coords, Int dim) {
   auto keys = hilbert::dists_from_coords(coords, dim);
   return sort_by_keys(keys, dim);
 }
 
+LOs sort_coords(Reals coords, Int dim, Int nbits) {
+  auto keys = hilbert::packed_dists_from_coords(coords, dim, nbits);
+  return sort_by_keys(keys, get_packed_width(dim, nbits));
+}
+
 }  // end namespace hilbert
 
 }  // end namespace Omega_h
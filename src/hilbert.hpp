@@ -98,12 +98,52 @@ INLINE void untranspose(coord_t const in[], coord_t out[], int b, int n) {
     out[i / b] |= (((in[i % n] >> (b - 1 - (i / n))) & 1) << (b - 1 - (i % b)));
 }
 
+/* packed Hilbert indices use words of at most 63 bits
+   so that they stay non-negative as I64 keys */
+constexpr int word_bits = 63;
+
+// pack the transposed (b*n)-bit Hilbert integer into words,
+// most significant first. every word but the last holds
+// exactly (word_bits) bits, so comparing the words
+// lexicographically compares the whole integer
+INLINE void transpose_to_words(
+    coord_t const in[], coord_t out[], int b, int n) {
+  int total = b * n;
+  int nwords = (total + word_bits - 1) / word_bits;
+  for (int w = 0; w < nwords; ++w) out[w] = 0;
+  for (int i = 0; i < total; ++i) {
+    int w = i / word_bits;
+    int wbits = (w + 1 < nwords) ? word_bits : (total - w * word_bits);
+    coord_t bit = (in[i % n] >> (b - 1 - (i / n))) & 1;
+    out[w] |= bit << (wbits - 1 - (i - w * word_bits));
+  }
+}
+
+/* for each point, (dim) integers holding a 52-bit per axis
+   Hilbert index, see hilbert.cpp */
+Read<I64> dists_from_coords(Reals coords, Int dim);
+
+/* for each point, the Hilbert index at (nbits / dim) bits per axis
+   (at most 52), packed into get_packed_width(dim, nbits) integers.
+   nbits=63 gives a single integer per point */
+Read<I64> packed_dists_from_coords(Reals coords, Int dim, Int nbits);
+/* same, but over the bounding box of the points on all ranks
+   of (comm), so that indices from different ranks are comparable */
+Read<I64> packed_dists_from_coords(
+    CommPtr comm, Reals coords, Int dim, Int nbits);
+Int get_axis_bits(Int dim, Int nbits);
+Int get_packed_width(Int dim, Int nbits);
+
 /* output a permutation from sorted points to input
    points, such that their ordering reflects the
    traversal of a fine-scale Hilbert curve over
    the bounding box of the points */
 LOs sort_coords(Reals coords, Int dim);
 
+/* same, but sorting packed indices with a budget
+   of (nbits) total bits per point */
+LOs sort_coords(Reals coords, Int dim, Int nbits);
+
 }  // end namespace hilbert
 
 }  // end namespace Omega_h
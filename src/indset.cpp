@@ -1,14 +1,51 @@
 #include "indset.hpp"
 
+#include <cmath>
+
 #include "array.hpp"
 #include "loop.hpp"
+#include "timer.hpp"
 
 namespace Omega_h {
 
+static IndsetStats indset_stats = {0, 0, 0.0};
+
+IndsetStats get_indset_stats() { return indset_stats; }
+
+void reset_indset_stats() { indset_stats = IndsetStats(); }
+
 namespace indset {
 
 enum { NOT_IN, IN, UNKNOWN };
 
+/* the number of quality bins INDSET_RANDOM tells apart */
+enum { NQUALITY_BINS = 16 };
+
+/* a fixed pseudo-random number in [0,1) for each global ID
+   (the splitmix64 finalizer), so that like the quality
+   priorities these do not depend on the partitioning */
+INLINE Real random_fraction(GO global) {
+  auto z = std::uint64_t(global) + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  z = z ^ (z >> 31);
+  return Real(z >> 11) / 9007199254740992.0;
+}
+
+/* a local maximum only has to beat neighbors in its own
+   bin, so chains of steadily increasing quality are cut
+   into pieces no longer than a run of random priorities */
+static Reals random_priorities(Reals quality, Read<GO> global) {
+  auto n = quality.size();
+  Write<Real> priorities(n);
+  auto f = LAMBDA(LO i) {
+    priorities[i] =
+        floor(quality[i] * NQUALITY_BINS) + random_fraction(global[i]);
+  };
+  parallel_for(n, f);
+  return priorities;
+}
+
 static Read<I8> local_iteration(
     LOs xadj, LOs adj, Reals quality, Read<GO> global, Read<I8> old_state) {
   auto n = global.size();
@@ -52,7 +89,8 @@ static Read<I8> iteration(Mesh* mesh, Int dim, LOs xadj, LOs adj, Reals quality,
 }
 
 static Read<I8> find(Mesh* mesh, Int dim, LOs xadj, LOs adj, Reals quality,
-    Read<GO> global, Read<I8> candidates) {
+    Read<GO> global, Read<I8> candidates, IndsetStrategy strategy) {
+  auto t0 = now();
   auto n = global.size();
   CHECK(quality.size() == n);
   CHECK(candidates.size() == n);
@@ -64,29 +102,43 @@ static Read<I8> find(Mesh* mesh, Int dim, LOs xadj, LOs adj, Reals quality,
       initial_state[i] = NOT_IN;
   };
   parallel_for(n, f);
+  if (strategy == INDSET_RANDOM) quality = random_priorities(quality, global);
   auto comm = mesh->comm();
   auto state = Read<I8>(initial_state);
-  while (comm->allreduce(max(state), OMEGA_H_MAX) == UNKNOWN) {
-    state = iteration(mesh, dim, xadj, adj, quality, global, state);
+  /* whether a state still has UNKNOWN entries is reduced while
+     the next state is computed, so the loop never blocks on a
+     global reduction. iterating on a finished state changes
+     nothing, so the one extra iteration at the end is harmless */
+  auto pending = comm->iallreduce(max(state), OMEGA_H_MAX);
+  while (true) {
+    auto next_state =
+        iteration(mesh, dim, xadj, adj, quality, global, state);
+    if (comm->wait(pending) != UNKNOWN) break;
+    state = next_state;
+    ++indset_stats.nrounds;
+    pending = comm->iallreduce(max(state), OMEGA_H_MAX);
   }
+  ++indset_stats.nsets;
+  indset_stats.seconds += now() - t0;
   return state;
 }
 }
 
-Read<I8> find_indset(
-    Mesh* mesh, Int ent_dim, Graph graph, Reals quality, Read<I8> candidates) {
+Read<I8> find_indset(Mesh* mesh, Int ent_dim, Graph graph, Reals quality,
+    Read<I8> candidates, IndsetStrategy strategy) {
   auto xadj = graph.a2ab;
   auto adj = graph.ab2b;
   auto globals = mesh->ask_globals(ent_dim);
-  return indset::find(mesh, ent_dim, xadj, adj, quality, globals, candidates);
+  return indset::find(
+      mesh, ent_dim, xadj, adj, quality, globals, candidates, strategy);
 }
 
-Read<I8> find_indset(
-    Mesh* mesh, Int ent_dim, Reals quality, Read<I8> candidates) {
+Read<I8> find_indset(Mesh* mesh, Int ent_dim, Reals quality,
+    Read<I8> candidates, IndsetStrategy strategy) {
   mesh->owners_have_all_upward(ent_dim);
   CHECK(mesh->owners_have_all_upward(ent_dim));
   auto graph = mesh->ask_star(ent_dim);
-  return find_indset(mesh, ent_dim, graph, quality, candidates);
+  return find_indset(mesh, ent_dim, graph, quality, candidates, strategy);
 }
 
 }  // end namespace Omega_h
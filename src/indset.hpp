@@ -5,10 +5,21 @@
 
 namespace Omega_h {
 
-Read<I8> find_indset(
-    Mesh* mesh, Int ent_dim, Graph graph, Reals quality, Read<I8> candidates);
-Read<I8> find_indset(
-    Mesh* mesh, Int ent_dim, Reals quality, Read<I8> candidates);
+Read<I8> find_indset(Mesh* mesh, Int ent_dim, Graph graph, Reals quality,
+    Read<I8> candidates, IndsetStrategy strategy);
+Read<I8> find_indset(Mesh* mesh, Int ent_dim, Reals quality,
+    Read<I8> candidates, IndsetStrategy strategy);
+
+/* totals over all calls to find_indset since the last reset.
+   rounds are the iterations needed to decide every candidate */
+struct IndsetStats {
+  GO nsets;
+  GO nrounds;
+  Real seconds;
+};
+
+IndsetStats get_indset_stats();
+void reset_indset_stats();
 
 }  // end namespace Omega_h
 
@@ -71,7 +71,7 @@ Reals get_distances(Reals coords, Vector<3> center, Vector<3> axis) {
   return distances;
 }
 
-Real get_half_weight(CommPtr comm, Reals masses, Read<I8> marked) {
+Real get_marked_weight(CommPtr comm, Reals masses, Read<I8> marked) {
   auto n = masses.size();
   Write<Real> weighted(n);
   auto f = LAMBDA(LO i) { weighted[i] = (Real(marked[i]) * masses[i]); };
@@ -87,22 +87,25 @@ Read<I8> mark_half(Reals distances, Real distance) {
   return marked;
 }
 
+/* finds the cutting distance that puts marked_fraction of
+   the total mass on the marked (far) side */
 bool mark_axis_bisection(CommPtr comm, Reals distances, Reals masses,
-    Real total_mass, Real tolerance, Read<I8>& marked) {
+    Real total_mass, Real marked_fraction, Real tolerance, Read<I8>& marked) {
   auto n = distances.size();
   CHECK(n == masses.size());
   auto max_dist = comm->allreduce(max(distances), OMEGA_H_MAX);
   auto min_dist = comm->allreduce(min(distances), OMEGA_H_MIN);
   auto range = max2(fabs(min_dist), fabs(max_dist));
   auto step = range / 2.;
+  auto target_weight = total_mass * marked_fraction;
   Real distance = 0.;
   for (Int i = 0; i < MANTISSA_BITS; ++i) {
     marked = mark_half(distances, distance);
-    auto half_weight = get_half_weight(comm, masses, marked);
-    if (are_close(half_weight, total_mass / 2., tolerance, 0.)) {
+    auto marked_weight = get_marked_weight(comm, masses, marked);
+    if (are_close(marked_weight, target_weight, tolerance, 0.)) {
       return true;
     }
-    if (half_weight > total_mass / 2.) {
+    if (marked_weight > target_weight) {
       distance += step;
     } else {
       distance -= step;
@@ -113,10 +116,12 @@ bool mark_axis_bisection(CommPtr comm, Reals distances, Reals masses,
 }
 
 Read<I8> mark_bisection_internal(CommPtr comm, Reals coords, Reals masses,
-    Real tolerance, Vector<3> axis, Vector<3> center, Real total_mass) {
+    Real tolerance, Vector<3> axis, Vector<3> center, Real total_mass,
+    Real marked_fraction) {
   auto dists = get_distances(coords, center, axis);
   Read<I8> marked;
-  if (mark_axis_bisection(comm, dists, masses, total_mass, tolerance, marked)) {
+  if (mark_axis_bisection(comm, dists, masses, total_mass, marked_fraction,
+          tolerance, marked)) {
     return marked;
   }
   // if we couldn't find a decent cutting plane, this may be a highly
@@ -126,8 +131,8 @@ Read<I8> mark_bisection_internal(CommPtr comm, Reals coords, Reals masses,
     auto axis2 = axis;
     axis2[i / 2] += (i % 2) ? 1e-3 : -1e-3;
     dists = get_distances(coords, center, axis2);
-    if (mark_axis_bisection(
-            comm, dists, masses, total_mass, tolerance, marked)) {
+    if (mark_axis_bisection(comm, dists, masses, total_mass, marked_fraction,
+            tolerance, marked)) {
       return marked;
     }
   }
@@ -142,23 +147,23 @@ Read<I8> mark_bisection_internal(CommPtr comm, Reals coords, Reals masses,
 
 }  // end anonymous namespace
 
-Read<I8> mark_bisection(
-    CommPtr comm, Reals coords, Reals masses, Real tolerance, Vector<3>& axis) {
+Read<I8> mark_bisection(CommPtr comm, Reals coords, Reals masses,
+    Real tolerance, Vector<3>& axis, Real marked_fraction) {
   CHECK(coords.size() == masses.size() * 3);
   auto total_mass = repro_sum(comm, masses);
   auto center = get_center(comm, coords, masses, total_mass);
   axis = get_axis(comm, coords, masses, center);
-  return mark_bisection_internal(
-      comm, coords, masses, tolerance, axis, center, total_mass);
+  return mark_bisection_internal(comm, coords, masses, tolerance, axis, center,
+      total_mass, marked_fraction);
 }
 
-Read<I8> mark_bisection_given_axis(
-    CommPtr comm, Reals coords, Reals masses, Real tolerance, Vector<3> axis) {
+Read<I8> mark_bisection_given_axis(CommPtr comm, Reals coords, Reals masses,
+    Real tolerance, Vector<3> axis, Real marked_fraction) {
   CHECK(coords.size() == masses.size() * 3);
   auto total_mass = repro_sum(comm, masses);
   auto center = get_center(comm, coords, masses, total_mass);
-  return mark_bisection_internal(
-      comm, coords, masses, tolerance, axis, center, total_mass);
+  return mark_bisection_internal(comm, coords, masses, tolerance, axis, center,
+      total_mass, marked_fraction);
 }
 
 Rib recursively_bisect(CommPtr comm, Reals& coords, Reals& masses,
@@ -166,23 +171,27 @@ Rib recursively_bisect(CommPtr comm, Reals& coords, Reals& masses,
   if (comm->size() == 1) {
     return Rib();
   }
-  CHECK(comm->size() % 2 == 0);
+  /* with an odd number of ranks, the upper half of the ranks
+     is one larger and receives a matching share of the mass */
+  auto nlow = comm->size() / 2;
+  auto marked_fraction = Real(comm->size() - nlow) / Real(comm->size());
   Vector<3> axis;
   Read<I8> marks;
   if (hints.axes.empty()) {
-    marks = inertia::mark_bisection(comm, coords, masses, tolerance, axis);
+    marks = inertia::mark_bisection(
+        comm, coords, masses, tolerance, axis, marked_fraction);
   } else {
     axis = hints.axes.front();
     hints.axes.erase(hints.axes.begin());
     marks = inertia::mark_bisection_given_axis(
-        comm, coords, masses, tolerance, axis);
+        comm, coords, masses, tolerance, axis, marked_fraction);
   }
   auto dist = bi_partition(comm, marks);
   coords = dist.exch(coords, 3);
   masses = dist.exch(masses, 1);
   owners = dist.exch(owners, 1);
-  auto halfsize = comm->size() / 2;
-  comm = comm->split(comm->rank() / halfsize, comm->rank() % halfsize);
+  auto half = I32(comm->rank() >= nlow);
+  comm = comm->split(half, comm->rank() - half * nlow);
   auto out = recursively_bisect(comm, coords, masses, owners, tolerance, hints);
   out.axes.insert(out.axes.begin(), axis);
   return out;
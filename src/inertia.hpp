@@ -11,10 +11,12 @@ struct Rib {
   std::vector<Vector<3>> axes;
 };
 
-Read<I8> mark_bisection(
-    CommPtr comm, Reals coords, Reals masses, Real tolerance, Vector<3>& axis);
-Read<I8> mark_bisection_given_axis(
-    CommPtr comm, Reals coords, Reals masses, Real tolerance, Vector<3> axis);
+/* marks the items on the far side of a plane normal to the axis,
+   chosen so that they hold marked_fraction of the total mass */
+Read<I8> mark_bisection(CommPtr comm, Reals coords, Reals masses,
+    Real tolerance, Vector<3>& axis, Real marked_fraction = 0.5);
+Read<I8> mark_bisection_given_axis(CommPtr comm, Reals coords, Reals masses,
+    Real tolerance, Vector<3> axis, Real marked_fraction = 0.5);
 Rib recursively_bisect(CommPtr comm, Reals& coords, Reals& masses,
     Remotes& owners, Real tolerance, Rib hints);
 }
@@ -2,41 +2,14 @@
 
 #include "align.hpp"
 #include "loop.hpp"
-#include "map.hpp"
+#include "scan.hpp"
+#include "sort.hpp"
 
 namespace Omega_h {
 
-static void order_by_globals(
-    LOs l2lh, Write<LO> lh2h, Write<I8> codes, Read<GO> hg) {
-  LO nl = l2lh.size() - 1;
-  auto f = LAMBDA(LO l) {
-    LO begin = l2lh[l];
-    LO end = l2lh[l + 1];
-    for (LO j = begin; j < end; ++j) {
-      LO k_min = j;
-      GO min_g = hg[lh2h[j]];
-      for (LO k = j + 1; k < end; ++k) {
-        GO g = hg[lh2h[k]];
-        if (g < min_g) {
-          k_min = k;
-          min_g = g;
-        }
-      }
-      swap2(lh2h[j], lh2h[k_min]);
-      swap2(codes[j], codes[k_min]);
-    }
-  };
-  parallel_for(nl, f);
-}
-
-Adj invert_adj(Adj down, Int nlows_per_high, LO nlows, Read<GO> high_globals) {
-  auto l2hl = invert_map_by_atomics(down.ab2b, nlows);
-  auto l2lh = l2hl.a2ab;
-  auto lh2hl = l2hl.ab2b;
+static void form_up_uses(LOs lh2hl, Read<I8> down_codes, Int nlows_per_high,
+    Write<LO> lh2h, Write<I8> codes) {
   LO nlh = lh2hl.size();
-  Read<I8> down_codes(down.codes);
-  Write<LO> lh2h(nlh);
-  Write<I8> codes(nlh);
   if (down_codes.exists()) {
     auto f = LAMBDA(LO lh) {
       LO hl = lh2hl[lh];
@@ -59,7 +32,76 @@ Adj invert_adj(Adj down, Int nlows_per_high, LO nlows, Read<GO> high_globals) {
     };
     parallel_for(nlh, f);
   }
-  order_by_globals(l2lh, lh2h, codes, high_globals);
+}
+
+static INLINE LO block_begin(LO n, Int nblocks, Int b) {
+  return static_cast<LO>((I64(n) * I64(b)) / I64(nblocks));
+}
+
+/* the uses of lows by highs are visited in increasing
+   order of high global number and bucketed by low with a
+   stable counting pass, so each row of the upward adjacency
+   comes out in global order without any per-row sorting.
+   the highs are split into contiguous blocks, each of which
+   keeps its own per-low counters; the counters of all blocks
+   for one low are scanned in block order, so the result does
+   not depend on how the blocks are scheduled.
+   the number of blocks is capped so that the counters take
+   no more memory than the uses themselves. */
+Adj invert_adj(Adj down, Int nlows_per_high, LO nlows, Read<GO> high_globals) {
+  auto hl2l = down.ab2b;
+  LO nhighs = high_globals.size();
+  CHECK(hl2l.size() == nhighs * nlows_per_high);
+  LO nlh = hl2l.size();
+  auto sorted2h = sort_by_keys(high_globals);
+  Int nblocks = 1;
+  if (nlows > 0) nblocks = min2(nhighs, min2(nlh / nlows, 64));
+  nblocks = max2(nblocks, 1);
+  Write<LO> block_counts(nblocks * nlows, 0);
+  auto count = LAMBDA(Int b) {
+    auto end = block_begin(nhighs, nblocks, b + 1);
+    for (LO s = block_begin(nhighs, nblocks, b); s < end; ++s) {
+      LO h = sorted2h[s];
+      for (Int which_down = 0; which_down < nlows_per_high; ++which_down) {
+        LO l = hl2l[h * nlows_per_high + which_down];
+        ++block_counts[b * nlows + l];
+      }
+    }
+  };
+  parallel_for(nblocks, count);
+  Write<LO> degrees(nlows);
+  auto total = LAMBDA(LO l) {
+    LO degree = 0;
+    for (Int b = 0; b < nblocks; ++b) degree += block_counts[b * nlows + l];
+    degrees[l] = degree;
+  };
+  parallel_for(nlows, total);
+  auto l2lh = offset_scan(LOs(degrees));
+  auto start = LAMBDA(LO l) {
+    LO lh = l2lh[l];
+    for (Int b = 0; b < nblocks; ++b) {
+      LO block_count = block_counts[b * nlows + l];
+      block_counts[b * nlows + l] = lh;
+      lh += block_count;
+    }
+  };
+  parallel_for(nlows, start);
+  Write<LO> lh2hl(nlh);
+  auto fill = LAMBDA(Int b) {
+    auto end = block_begin(nhighs, nblocks, b + 1);
+    for (LO s = block_begin(nhighs, nblocks, b); s < end; ++s) {
+      LO h = sorted2h[s];
+      for (Int which_down = 0; which_down < nlows_per_high; ++which_down) {
+        LO hl = h * nlows_per_high + which_down;
+        LO l = hl2l[hl];
+        lh2hl[block_counts[b * nlows + l]++] = hl;
+      }
+    }
+  };
+  parallel_for(nblocks, fill);
+  Write<LO> lh2h(nlh);
+  Write<I8> codes(nlh);
+  form_up_uses(lh2hl, down.codes, nlows_per_high, lh2h, codes);
   return Adj(l2lh, lh2h, codes);
 }
 
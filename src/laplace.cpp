@@ -29,8 +29,13 @@ Reals solve_laplacian(
     auto new_state_w = deep_copy(new_state_nobc);
     map_into(bc_data, b2v, new_state_w, width);
     auto new_state = Reals(new_state_w);
-    new_state = mesh->sync_array(VERT, new_state, width);
-    auto local_done = are_close(state, new_state, tol, floor);
+    auto sync = mesh->sync_array_start(VERT, new_state, width);
+    /* syncing leaves owned values unchanged and copies end up
+       equal to their owners, so checking only owned values
+       gives the same answer and can overlap the sync */
+    auto local_done = are_close(mesh->owned_array(VERT, state, width),
+        mesh->owned_array(VERT, new_state, width), tol, floor);
+    new_state = mesh->sync_array_finish(VERT, sync);
     done = comm->reduce_and(local_done);
     state = new_state;
     ++niters;
@@ -3,12 +3,26 @@
 
 #include "internal.hpp"
 
+#if defined(OMEGA_H_USE_OPENMP) && !defined(OMEGA_H_USE_KOKKOS)
+#include <omp.h>
+#include <vector>
+#endif
+
 namespace Omega_h {
 
+/* without Kokkos, OMEGA_H_USE_OPENMP selects the native
+   OpenMP backend below. parallel_for and parallel_reduce
+   use the configure-time OMEGA_H_OPENMP_SCHEDULE clause,
+   e.g. "static" or "dynamic,4096".
+   parallel_scan always uses one contiguous block per thread */
+
 template <typename T>
 void parallel_for(Int n, T const& f) {
-#ifdef OMEGA_H_USE_KOKKOS
+#if defined(OMEGA_H_USE_KOKKOS)
   if (n > 0) Kokkos::parallel_for(static_cast<std::size_t>(n), f);
+#elif defined(OMEGA_H_USE_OPENMP)
+#pragma omp parallel for schedule(OMEGA_H_OPENMP_SCHEDULE)
+  for (Int i = 0; i < n; ++i) f(i);
 #else
   for (Int i = 0; i < n; ++i) f(i);
 #endif
@@ -21,8 +35,26 @@ typename T::value_type parallel_reduce(Int n, T f) {
       "reduction value types need to be at least word-sized");
   VT result;
   f.init(result);
-#ifdef OMEGA_H_USE_KOKKOS
+#if defined(OMEGA_H_USE_KOKKOS)
   if (n > 0) Kokkos::parallel_reduce(static_cast<std::size_t>(n), f, result);
+#elif defined(OMEGA_H_USE_OPENMP)
+  /* partial results are joined in thread order so that
+     a fixed thread count and static schedule give
+     reproducible floating-point answers. the team may be
+     smaller than omp_get_max_threads(), so every partial
+     starts out as the identity */
+  std::vector<VT> partials(static_cast<std::size_t>(omp_get_max_threads()));
+  for (auto& partial : partials) f.init(partial);
+#pragma omp parallel
+  {
+    auto t = static_cast<std::size_t>(omp_get_thread_num());
+    VT update;
+    f.init(update);
+#pragma omp for schedule(OMEGA_H_OPENMP_SCHEDULE)
+    for (Int i = 0; i < n; ++i) f(i, update);
+    partials[t] = update;
+  }
+  for (auto& partial : partials) f.join(result, partial);
 #else
   for (Int i = 0; i < n; ++i) f(i, result);
 #endif
@@ -34,8 +66,31 @@ void parallel_scan(Int n, T f) {
   typedef typename T::value_type VT;
   static_assert(sizeof(VT) >= sizeof(void*),
       "reduction value types need to be at least word-sized");
-#ifdef OMEGA_H_USE_KOKKOS
+#if defined(OMEGA_H_USE_KOKKOS)
   if (n > 0) Kokkos::parallel_scan(static_cast<std::size_t>(n), f);
+#elif defined(OMEGA_H_USE_OPENMP)
+  /* two-pass blocked scan: each thread reduces its block,
+     the block totals are scanned serially, then each thread
+     re-runs its block in final mode starting from its prefix */
+  std::vector<VT> partials(static_cast<std::size_t>(omp_get_max_threads()));
+#pragma omp parallel
+  {
+    auto nthreads = omp_get_num_threads();
+    auto t = omp_get_thread_num();
+    auto block = (n + nthreads - 1) / nthreads;
+    auto begin = min2(n, t * block);
+    auto end = min2(n, begin + block);
+    VT update;
+    f.init(update);
+    for (Int i = begin; i < end; ++i) f(i, update, false);
+    partials[static_cast<std::size_t>(t)] = update;
+#pragma omp barrier
+    f.init(update);
+    for (Int j = 0; j < t; ++j) {
+      f.join(update, partials[static_cast<std::size_t>(j)]);
+    }
+    for (Int i = begin; i < end; ++i) f(i, update, true);
+  }
 #else
   VT update;
   f.init(update);
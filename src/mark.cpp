@@ -96,11 +96,16 @@ Read<I8> mark_dual_layers(Mesh* mesh, Read<I8> marks, Int nlayers) {
   return marks;
 }
 
-GO count_owned_marks(Mesh* mesh, Int ent_dim, Read<I8> marks) {
+LO count_local_owned_marks(Mesh* mesh, Int ent_dim, Read<I8> marks) {
   if (mesh->could_be_shared(ent_dim)) {
     marks = land_each(marks, mesh->owned(ent_dim));
   }
-  return mesh->comm()->allreduce(GO(sum(marks)), OMEGA_H_SUM);
+  return sum(marks);
+}
+
+GO count_owned_marks(Mesh* mesh, Int ent_dim, Read<I8> marks) {
+  auto nlocal = count_local_owned_marks(mesh, ent_dim, marks);
+  return mesh->comm()->allreduce(GO(nlocal), OMEGA_H_SUM);
 }
 
 Read<I8> mark_sliver_layers(Mesh* mesh, Real qual_ceil, Int nlayers) {
@@ -18,6 +18,7 @@ Read<I8> mark_by_owner(Mesh* mesh, Int ent_dim, I32 rank);
 
 Read<I8> mark_dual_layers(Mesh* mesh, Read<I8> marks, Int nlayers);
 
+LO count_local_owned_marks(Mesh* mesh, Int ent_dim, Read<I8> marks);
 GO count_owned_marks(Mesh* mesh, Int ent_dim, Read<I8> marks);
 
 Read<I8> mark_sliver_layers(Mesh* mesh, Real qual_ceil, Int nlayers);
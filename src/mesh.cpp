@@ -1,6 +1,5 @@
 #include "internal.hpp"
 
-#include <algorithm>
 #include <iostream>
 
 #include "adjacency.hpp"
@@ -8,12 +7,14 @@
 #include "bcast.hpp"
 #include "ghost.hpp"
 #include "graph.hpp"
+#include "graphpart.hpp"
 #include "inertia.hpp"
 #include "map.hpp"
 #include "mark.hpp"
 #include "migrate.hpp"
 #include "quality.hpp"
 #include "reorder.hpp"
+#include "sfcpart.hpp"
 #include "simplices.hpp"
 #include "size.hpp"
 #include "tag.hpp"
@@ -22,11 +23,18 @@ namespace Omega_h {
 
 Mesh::Mesh(Library* library) : dim_(-1) {
   for (Int i = 0; i <= 3; ++i) nents_[i] = -1;
+  for (Int i = 0; i <= 3; ++i) sync_packed_rows_[i] = -1;
   parting_ = OMEGA_H_ELEM_BASED;
   nghost_layers_ = 0;
   keeps_canonical_globals_ = true;
   CHECK(library != nullptr);
   library_ = library;
+  cache_budget_ = 0;
+  cache_clock_ = 0;
+  for (Int i = 0; i < NCACHES; ++i) {
+    cache_uses_[i] = 0;
+    cache_pins_[i] = false;
+  }
 }
 
 Library* Mesh::library() const { return library_; }
@@ -53,6 +61,7 @@ void Mesh::set_comm(CommPtr const& new_comm) {
   /* if some ranks already have mesh data, their
      parallel info needs updating, we'll do this
      by using the old Dist to set new owners */
+  for (Int d = 0; d < DIMS; ++d) sync_packed_rows_[d] = -1;
   if (0 < nnew_had_comm) {
     for (Int d = 0; d <= dim(); ++d) {
       /* in the case of serial to parallel, globals may not be
@@ -127,6 +136,7 @@ void Mesh::add_tag(
   CHECK(ncomps >= 0);
   CHECK(ncomps <= Int(INT8_MAX));
   CHECK(tags_[dim].size() < size_t(INT8_MAX));
+  tag_indices_[dim][name] = tags_[dim].size();
   tags_[dim].push_back(TagPtr(new Tag<T>(name, ncomps, xfer, outflags)));
 }
 
@@ -192,6 +202,7 @@ void Mesh::remove_tag(Int dim, std::string const& name) {
   check_dim2(dim);
   CHECK(has_tag(dim, name));
   tags_[dim].erase(tag_iter(dim, name));
+  index_tags(dim);
 }
 
 bool Mesh::has_tag(Int dim, std::string const& name) const {
@@ -251,20 +262,25 @@ Graph Mesh::ask_star(Int dim) {
 
 Graph Mesh::ask_dual() { return ask_adj(dim(), dim()); }
 
-struct HasName {
-  std::string const& name_;
-  HasName(std::string const& name) : name_(name) {}
-  bool operator()(std::shared_ptr<TagBase> const& a) {
-    return a->name() == name_;
+/* removal shifts the tags after it, so the whole
+   index is rebuilt. removals are rare compared to lookups */
+void Mesh::index_tags(Int dim) {
+  tag_indices_[dim].clear();
+  for (std::size_t i = 0; i < tags_[dim].size(); ++i) {
+    tag_indices_[dim][tags_[dim][i]->name()] = i;
   }
-};
+}
 
 Mesh::TagIter Mesh::tag_iter(Int dim, std::string const& name) {
-  return std::find_if(tags_[dim].begin(), tags_[dim].end(), HasName(name));
+  auto it = tag_indices_[dim].find(name);
+  if (it == tag_indices_[dim].end()) return tags_[dim].end();
+  return tags_[dim].begin() + static_cast<std::ptrdiff_t>(it->second);
 }
 
 Mesh::TagCIter Mesh::tag_iter(Int dim, std::string const& name) const {
-  return std::find_if(tags_[dim].begin(), tags_[dim].end(), HasName(name));
+  auto it = tag_indices_[dim].find(name);
+  if (it == tag_indices_[dim].end()) return tags_[dim].end();
+  return tags_[dim].begin() + static_cast<std::ptrdiff_t>(it->second);
 }
 
 void Mesh::check_dim(Int dim) const {
@@ -343,13 +359,129 @@ Adj Mesh::ask_adj(Int from, Int to) {
   check_dim2(from);
   check_dim2(to);
   if (has_adj(from, to)) {
+    if (is_derived_adj(from, to)) touch_cache(from * DIMS + to);
     return get_adj(from, to);
   }
+  MemoryLabel label("adj");
   Adj derived = derive_adj(from, to);
   adjs_[from][to] = std::make_shared<Adj>(derived);
+  touch_cache(from * DIMS + to);
+  enforce_cache_budget(from * DIMS + to);
   return derived;
 }
 
+/* only the downward adjacencies given to set_ents() are
+   original data, everything else in adjs_ was derived */
+bool Mesh::is_derived_adj(Int from, Int to) const { return from != to + 1; }
+
+Int Mesh::cached_tag_slot(std::string const& name) const {
+  if (name == "length") return LENGTH_CACHE;
+  if (name == "quality") return QUALITY_CACHE;
+  Omega_h_fail("\"%s\" is not a cached tag\n", name.c_str());
+  NORETURN(-1);
+}
+
+bool Mesh::has_cache(Int slot) const {
+  if (dim_ == -1) return false;
+  if (slot == LENGTH_CACHE) return has_tag(EDGE, "length");
+  if (slot == QUALITY_CACHE) return has_tag(dim(), "quality");
+  return bool(adjs_[slot / DIMS][slot % DIMS]);
+}
+
+static std::size_t adj_bytes(Adj const& adj) {
+  std::size_t bytes = 0;
+  if (adj.a2ab.exists()) bytes += std::size_t(adj.a2ab.size()) * sizeof(LO);
+  if (adj.ab2b.exists()) bytes += std::size_t(adj.ab2b.size()) * sizeof(LO);
+  if (adj.codes.exists()) bytes += std::size_t(adj.codes.size()) * sizeof(I8);
+  return bytes;
+}
+
+std::size_t Mesh::cache_bytes(Int slot) const {
+  if (!has_cache(slot)) return 0;
+  if (slot == LENGTH_CACHE) {
+    return std::size_t(nedges()) * sizeof(Real);
+  }
+  if (slot == QUALITY_CACHE) {
+    return std::size_t(nelems()) * sizeof(Real);
+  }
+  return adj_bytes(*(adjs_[slot / DIMS][slot % DIMS]));
+}
+
+void Mesh::drop_cache(Int slot) {
+  if (slot == LENGTH_CACHE) {
+    if (has_tag(EDGE, "length")) remove_tag(EDGE, "length");
+  } else if (slot == QUALITY_CACHE) {
+    if (has_tag(dim(), "quality")) remove_tag(dim(), "quality");
+  } else {
+    adjs_[slot / DIMS][slot % DIMS] = AdjPtr();
+  }
+}
+
+void Mesh::touch_cache(Int slot) { cache_uses_[slot] = ++cache_clock_; }
+
+void Mesh::enforce_cache_budget(Int keep_slot) {
+  if (!cache_budget_) return;
+  while (cached_bytes() > cache_budget_) {
+    Int victim = -1;
+    for (Int slot = 0; slot < NCACHES; ++slot) {
+      if (slot == keep_slot || cache_pins_[slot] || !has_cache(slot)) continue;
+      if (slot < LENGTH_CACHE && !is_derived_adj(slot / DIMS, slot % DIMS)) {
+        continue;
+      }
+      if (victim == -1 || cache_uses_[slot] < cache_uses_[victim]) {
+        victim = slot;
+      }
+    }
+    if (victim == -1) return;
+    drop_cache(victim);
+  }
+}
+
+void Mesh::set_cache_budget(std::size_t bytes) {
+  cache_budget_ = bytes;
+  enforce_cache_budget(-1);
+}
+
+std::size_t Mesh::cache_budget() const { return cache_budget_; }
+
+std::size_t Mesh::cached_bytes() const {
+  std::size_t bytes = 0;
+  for (Int slot = 0; slot < NCACHES; ++slot) {
+    if (slot < LENGTH_CACHE && !is_derived_adj(slot / DIMS, slot % DIMS)) {
+      continue;
+    }
+    bytes += cache_bytes(slot);
+  }
+  return bytes;
+}
+
+void Mesh::pin_adj(Int from, Int to, bool pinned) {
+  check_dim(from);
+  check_dim(to);
+  cache_pins_[from * DIMS + to] = pinned;
+}
+
+void Mesh::drop_adj(Int from, Int to) {
+  check_dim(from);
+  check_dim(to);
+  CHECK(is_derived_adj(from, to));
+  adjs_[from][to] = AdjPtr();
+}
+
+void Mesh::pin_cached_tag(std::string const& name, bool pinned) {
+  cache_pins_[cached_tag_slot(name)] = pinned;
+}
+
+void Mesh::drop_caches() {
+  for (Int slot = 0; slot < NCACHES; ++slot) {
+    if (cache_pins_[slot]) continue;
+    if (slot < LENGTH_CACHE && !is_derived_adj(slot / DIMS, slot % DIMS)) {
+      continue;
+    }
+    drop_cache(slot);
+  }
+}
+
 void Mesh::add_coords(Reals array) {
   add_tag<Real>(
       0, "coordinates", dim(), OMEGA_H_LINEAR_INTERP, OMEGA_H_DO_OUTPUT, array);
@@ -381,17 +513,23 @@ void Mesh::reset_globals() {
 
 Reals Mesh::ask_lengths() {
   if (!has_tag(EDGE, "length")) {
+    MemoryLabel label("tag:length");
     auto lengths = measure_edges_metric(this);
     add_tag(EDGE, "length", 1, OMEGA_H_LENGTH, OMEGA_H_DO_OUTPUT, lengths);
+    enforce_cache_budget(LENGTH_CACHE);
   }
+  touch_cache(LENGTH_CACHE);
   return get_array<Real>(EDGE, "length");
 }
 
 Reals Mesh::ask_qualities() {
   if (!has_tag(dim(), "quality")) {
+    MemoryLabel label("tag:quality");
     auto qualities = measure_qualities(this);
     add_tag(dim(), "quality", 1, OMEGA_H_QUALITY, OMEGA_H_DO_OUTPUT, qualities);
+    enforce_cache_budget(QUALITY_CACHE);
   }
+  touch_cache(QUALITY_CACHE);
   return get_array<Real>(dim(), "quality");
 }
 
@@ -401,6 +539,7 @@ void Mesh::set_owners(Int dim, Remotes owners) {
   CHECK(nents(dim) == owners.idxs.size());
   owners_[dim] = owners;
   dists_[dim] = DistPtr();
+  sync_packed_rows_[dim] = -1;
 }
 
 Remotes Mesh::ask_owners(Int dim) {
@@ -417,8 +556,18 @@ Read<I8> Mesh::owned(Int dim) {
   return each_eq_to(e2rank, comm()->rank());
 }
 
+/* reduced once per Dist, on every rank that syncs */
+GO Mesh::ask_sync_packed_rows(Int dim) {
+  if (sync_packed_rows_[dim] < 0) {
+    sync_packed_rows_[dim] = comm_->allreduce(
+        get_max_packed_rows(ask_dist(dim).invert()), OMEGA_H_MAX);
+  }
+  return sync_packed_rows_[dim];
+}
+
 Dist Mesh::ask_dist(Int dim) {
   if (!dists_[dim]) {
+    MemoryLabel label("dist");
     auto owners = ask_owners(dim);
     CHECK(owners.ranks.exists());
     CHECK(owners.idxs.exists());
@@ -458,6 +607,8 @@ void Mesh::set_parting(Omega_h_Parting parting, Int nlayers, bool verbose) {
   if (parting_ == parting && nghost_layers_ == nlayers) {
     return;
   }
+  MemoryLabel label("ghost");
+  CommRegion region("ghost");
   if (parting == OMEGA_H_ELEM_BASED) {
     CHECK(nlayers == 0);
     if (comm_->size() > 1) partition_by_elems(this, verbose);
@@ -482,40 +633,76 @@ void Mesh::set_parting(Omega_h_Parting parting, bool verbose) {
 }
 
 void Mesh::migrate(Remotes new_elems2old_owners, bool verbose) {
+  MemoryLabel label("migrate");
+  CommRegion region("migrate");
   migrate_mesh(this, new_elems2old_owners, verbose);
 }
 
 void Mesh::reorder() { reorder_by_hilbert(this); }
 
-void Mesh::balance(bool predictive) {
+Reals get_balance_masses(Mesh* mesh, bool predictive) {
+  if (!predictive) return Reals(mesh->nelems(), 1);
+  Reals masses;
+  if (mesh->has_tag(VERT, "size")) {
+    masses = expected_elems_per_elem_iso(
+        mesh, mesh->get_array<Real>(VERT, "size"));
+  } else if (mesh->has_tag(VERT, "metric")) {
+    masses = expected_elems_per_elem_metric(
+        mesh, mesh->get_array<Real>(VERT, "metric"));
+  }
+  /* average between input mesh weight (1.0)
+     and predicted output mesh weight */
+  masses = add_to_each(masses, 1.);
+  return multiply_each_by(1. / 2., masses);
+}
+
+void Mesh::balance(bool predictive, Omega_h_Partitioner partitioner) {
   if (comm_->size() == 1) return;
   set_parting(OMEGA_H_ELEM_BASED);
-  inertia::Rib hints;
-  if (rib_hints_) hints = *rib_hints_;
   auto ecoords =
       average_field(this, dim(), LOs(nelems(), 0, 1), dim(), coords());
-  if (dim() == 2) ecoords = vectors_2d_to_3d(ecoords);
-  Reals masses;
-  if (predictive) {
-    if (has_tag(VERT, "size")) {
-      masses = expected_elems_per_elem_iso(this, get_array<Real>(VERT, "size"));
-    } else if (has_tag(VERT, "metric")) {
-      masses =
-          expected_elems_per_elem_metric(this, get_array<Real>(VERT, "metric"));
-    }
-    /* average between input mesh weight (1.0)
-       and predicted output mesh weight */
-    masses = add_to_each(masses, 1.);
-    masses = multiply_each_by(1. / 2., masses);
-  } else {
-    masses = Reals(nelems(), 1);
-  }
+  auto masses = get_balance_masses(this, predictive);
   auto owners = ask_owners(dim());
   auto total = comm_->allreduce(GO(nelems()), OMEGA_H_SUM);
   auto avg = Real(total) / Real(comm_->size());
+  if (partitioner == OMEGA_H_HILBERT) {
+    /* one cut of the curve and one migration, no RIB hints involved */
+    auto parts = get_hilbert_parts(comm_, ecoords, dim(), masses, 2.0 / avg);
+    Dist elems2parts;
+    elems2parts.set_parent_comm(comm_);
+    elems2parts.set_dest_ranks(parts);
+    migrate(elems2parts.exch(owners, 1));
+    return;
+  }
+  inertia::Rib hints;
+  if (rib_hints_) hints = *rib_hints_;
+  if (dim() == 2) ecoords = vectors_2d_to_3d(ecoords);
   hints = recursively_bisect(comm(), ecoords, masses, owners, 2.0 / avg, hints);
   rib_hints_ = std::make_shared<inertia::Rib>(hints);
   migrate(owners);
+  if (partitioner == OMEGA_H_GRAPH) {
+    /* the masses from before the migration no longer line up */
+    masses = get_balance_masses(this, predictive);
+    refine_graph_partition(this, masses, 1.05);
+  }
+}
+
+void Mesh::merge_parts(I32 nparts) {
+  CHECK(0 < nparts && nparts <= comm_->size());
+  set_parting(OMEGA_H_ELEM_BASED);
+  /* consecutive ranks merge, since partitioners like
+     RIB tend to give them neighboring parts */
+  auto dest = I32((I64(comm_->rank()) * nparts) / comm_->size());
+  Dist elems2parts;
+  elems2parts.set_parent_comm(comm_);
+  elems2parts.set_dest_ranks(Read<I32>(nelems(), dest));
+  migrate(elems2parts.exch(ask_owners(dim()), 1));
+  /* creating the graph communicators takes every rank
+     of the current communicator, so they must exist before
+     the remaining ranks move on to set_comm() by themselves */
+  for (Int d = 0; d <= dim(); ++d) ask_dist(d);
+  /* the hints have one axis per bisection of the old rank count */
+  rib_hints_ = RibPtr();
 }
 
 Graph Mesh::ask_graph(Int from, Int to) {
@@ -537,6 +724,23 @@ Read<T> Mesh::sync_array(Int ent_dim, Read<T> a, Int width) {
   return ask_dist(ent_dim).invert().exch(a, width);
 }
 
+template <typename T>
+DistExchange<T> Mesh::sync_array_start(Int ent_dim, Read<T> a, Int width) {
+  if (!could_be_shared(ent_dim)) {
+    DistExchange<T> exchange;
+    exchange.request.result = a;
+    exchange.width = width;
+    return exchange;
+  }
+  return ask_dist(ent_dim).invert().exch_start(a, width);
+}
+
+template <typename T>
+Read<T> Mesh::sync_array_finish(Int ent_dim, DistExchange<T>& exchange) {
+  if (!could_be_shared(ent_dim)) return exchange.request.result;
+  return ask_dist(ent_dim).invert().exch_finish(exchange);
+}
+
 template <typename T>
 Read<T> Mesh::sync_subset_array(
     Int ent_dim, Read<T> a_data, LOs a2e, T default_val, Int width) {
@@ -586,6 +790,44 @@ void Mesh::sync_tag(Int dim, std::string const& name) {
   }
 }
 
+void Mesh::sync_tags(Int dim, std::vector<std::string> const& names) {
+  if (!could_be_shared(dim)) return;
+  std::vector<TagBase const*> tags;
+  for (auto& name : names) tags.push_back(get_tagbase(dim, name));
+  if (!get_packed_row_bytes(tags)) return;
+  auto max_nents = ask_sync_packed_rows(dim);
+  for (auto& group : group_packable_tags(tags, max_nents)) {
+    if (can_pack_tags(group, max_nents)) {
+      sync_packed_tags(dim, group);
+    } else {
+      sync_tag(dim, group[0]->name());
+    }
+  }
+}
+
+void Mesh::sync_packed_tags(Int dim, std::vector<TagBase const*> const& tags) {
+  auto row_bytes = get_packed_row_bytes(tags);
+  auto rows = pack_tags(tags, nents(dim));
+  rows = sync_array(dim, rows, row_bytes);
+  auto new_tags = unpack_tags(tags, rows, nents(dim));
+  for (auto& tag : new_tags) {
+    switch (tag->type()) {
+      case OMEGA_H_I8:
+        set_tag(dim, tag->name(), to<I8>(tag.get())->array());
+        break;
+      case OMEGA_H_I32:
+        set_tag(dim, tag->name(), to<I32>(tag.get())->array());
+        break;
+      case OMEGA_H_I64:
+        set_tag(dim, tag->name(), to<I64>(tag.get())->array());
+        break;
+      case OMEGA_H_F64:
+        set_tag(dim, tag->name(), to<Real>(tag.get())->array());
+        break;
+    }
+  }
+}
+
 void Mesh::reduce_tag(Int dim, std::string const& name, Omega_h_Op op) {
   auto tagbase = get_tagbase(dim, name);
   switch (tagbase->type()) {
@@ -646,6 +888,8 @@ Mesh Mesh::copy_meta() const {
   m.nghost_layers_ = this->nghost_layers_;
   m.rib_hints_ = this->rib_hints_;
   m.keeps_canonical_globals_ = this->keeps_canonical_globals_;
+  m.cache_budget_ = this->cache_budget_;
+  for (Int i = 0; i < NCACHES; ++i) m.cache_pins_[i] = this->cache_pins_[i];
   return m;
 }
 
@@ -664,6 +908,10 @@ void Mesh::set_rib_hints(RibPtr hints) { rib_hints_ = hints; }
   template void Mesh::set_tag(                                                 \
       Int dim, std::string const& name, Read<T> array, bool internal);         \
   template Read<T> Mesh::sync_array(Int ent_dim, Read<T> a, Int width);        \
+  template DistExchange<T> Mesh::sync_array_start(                             \
+      Int ent_dim, Read<T> a, Int width);                                      \
+  template Read<T> Mesh::sync_array_finish(                                    \
+      Int ent_dim, DistExchange<T> & exchange);                                \
   template Read<T> Mesh::owned_array(Int ent_dim, Read<T> a, Int width);       \
   template Read<T> Mesh::sync_subset_array(                                    \
       Int ent_dim, Read<T> a_data, LOs a2e, T default_val, Int width);         \
@@ -107,38 +107,89 @@ void push_down(Mesh* old_mesh, Int ent_dim, Int low_dim,
   new_ents2new_lows.codes = new_codes;
 }
 
-void push_tags(Mesh const* old_mesh, Mesh* new_mesh, Int ent_dim,
+static void push_tag(Mesh* new_mesh, Int ent_dim, TagBase const* tag,
     Dist old_owners2new_ents) {
-  CHECK(old_owners2new_ents.nroots() == old_mesh->nents(ent_dim));
-  for (Int i = 0; i < old_mesh->ntags(ent_dim); ++i) {
-    auto tag = old_mesh->get_tag(ent_dim, i);
-    if (is<I8>(tag)) {
-      auto array = to<I8>(tag)->array();
-      array = old_owners2new_ents.exch(array, tag->ncomps());
+  switch (tag->type()) {
+    case OMEGA_H_I8:
       new_mesh->add_tag<I8>(ent_dim, tag->name(), tag->ncomps(), tag->xfer(),
-          tag->outflags(), array, true);
-    } else if (is<I32>(tag)) {
-      auto array = to<I32>(tag)->array();
-      array = old_owners2new_ents.exch(array, tag->ncomps());
+          tag->outflags(),
+          old_owners2new_ents.exch(to<I8>(tag)->array(), tag->ncomps()), true);
+      break;
+    case OMEGA_H_I32:
       new_mesh->add_tag<I32>(ent_dim, tag->name(), tag->ncomps(), tag->xfer(),
-          tag->outflags(), array, true);
-    } else if (is<I64>(tag)) {
-      auto array = to<I64>(tag)->array();
-      array = old_owners2new_ents.exch(array, tag->ncomps());
+          tag->outflags(),
+          old_owners2new_ents.exch(to<I32>(tag)->array(), tag->ncomps()), true);
+      break;
+    case OMEGA_H_I64:
       new_mesh->add_tag<I64>(ent_dim, tag->name(), tag->ncomps(), tag->xfer(),
-          tag->outflags(), array, true);
-    } else if (is<Real>(tag)) {
-      auto array = to<Real>(tag)->array();
-      array = old_owners2new_ents.exch(array, tag->ncomps());
-      new_mesh->add_tag<Real>(ent_dim, tag->name(), tag->ncomps(), tag->xfer(),
-          tag->outflags(), array, true);
+          tag->outflags(),
+          old_owners2new_ents.exch(to<I64>(tag)->array(), tag->ncomps()), true);
+      break;
+    case OMEGA_H_F64:
+      new_mesh->add_tag<Real>(ent_dim, tag->name(), tag->ncomps(),
+          tag->xfer(), tag->outflags(),
+          old_owners2new_ents.exch(to<Real>(tag)->array(), tag->ncomps()),
+          true);
+      break;
+  }
+}
+
+static void push_packed_tags(Mesh* new_mesh, Int ent_dim,
+    std::vector<TagBase const*> const& tags, LO nold_ents,
+    Dist old_owners2new_ents) {
+  auto row_bytes = get_packed_row_bytes(tags);
+  auto rows = pack_tags(tags, nold_ents);
+  rows = old_owners2new_ents.exch(rows, row_bytes);
+  auto nnew_ents =
+      row_bytes ? rows.size() / row_bytes : old_owners2new_ents.ndests();
+  auto new_tags = unpack_tags(tags, rows, nnew_ents);
+  for (auto& tag : new_tags) {
+    switch (tag->type()) {
+      case OMEGA_H_I8:
+        new_mesh->add_tag<I8>(ent_dim, tag->name(), tag->ncomps(), tag->xfer(),
+            tag->outflags(), to<I8>(tag.get())->array(), true);
+        break;
+      case OMEGA_H_I32:
+        new_mesh->add_tag<I32>(ent_dim, tag->name(), tag->ncomps(),
+            tag->xfer(), tag->outflags(), to<I32>(tag.get())->array(), true);
+        break;
+      case OMEGA_H_I64:
+        new_mesh->add_tag<I64>(ent_dim, tag->name(), tag->ncomps(),
+            tag->xfer(), tag->outflags(), to<I64>(tag.get())->array(), true);
+        break;
+      case OMEGA_H_F64:
+        new_mesh->add_tag<Real>(ent_dim, tag->name(), tag->ncomps(),
+            tag->xfer(), tag->outflags(), to<Real>(tag.get())->array(), true);
+        break;
+    }
+  }
+}
+
+void push_tags(Mesh const* old_mesh, Mesh* new_mesh, Int ent_dim,
+    Dist old_owners2new_ents, GO max_nents) {
+  CHECK(old_owners2new_ents.nroots() == old_mesh->nents(ent_dim));
+  /* the tags travel together in as few exchanges as their
+     packed arrays allow */
+  std::vector<TagBase const*> tags;
+  for (Int i = 0; i < old_mesh->ntags(ent_dim); ++i) {
+    tags.push_back(old_mesh->get_tag(ent_dim, i));
+  }
+  if (tags.empty()) return;
+  auto nold_ents = old_mesh->nents(ent_dim);
+  for (auto& group : group_packable_tags(tags, max_nents)) {
+    if (can_pack_tags(group, max_nents)) {
+      push_packed_tags(new_mesh, ent_dim, group, nold_ents, old_owners2new_ents);
+    } else {
+      push_tag(new_mesh, ent_dim, group[0], old_owners2new_ents);
     }
   }
 }
 
 void push_ents(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
-    Dist new_ents2old_owners, Dist old_owners2new_ents, Omega_h_Parting mode) {
-  push_tags(old_mesh, new_mesh, ent_dim, old_owners2new_ents);
+    Dist new_ents2old_owners, Dist old_owners2new_ents, Omega_h_Parting mode,
+    GO max_packed_rows) {
+  push_tags(
+      old_mesh, new_mesh, ent_dim, old_owners2new_ents, max_packed_rows);
   Read<I32> own_ranks;
   /* if we are ghosting, each entity should remain owned by the
    * same rank that owned it before ghosting, as this is the only
@@ -183,24 +234,31 @@ void migrate_mesh(Mesh* old_mesh, Mesh* new_mesh, Dist new_elems2old_owners,
   auto comm = old_mesh->comm();
   auto dim = old_mesh->dim();
   if (verbose) print_migrate_stats(comm, new_elems2old_owners);
-  Dist new_ents2old_owners = new_elems2old_owners;
-  auto old_owners2new_ents = new_ents2old_owners.invert();
+  /* the Dists of all dimensions come first, so that the
+     bounds for packing each dimension's tags are reduced
+     in one call */
+  Dist old_owners2new_ents[DIMS];
+  Adj new_ents2new_lows[DIMS];
+  old_owners2new_ents[dim] = new_elems2old_owners.invert();
+  for (Int d = dim; d > VERT; --d) {
+    push_down(old_mesh, d, d - 1, old_owners2new_ents[d], new_ents2new_lows[d],
+        old_owners2new_ents[d - 1]);
+  }
+  GO max_packed_rows[DIMS];
+  for (Int d = 0; d <= dim; ++d) {
+    max_packed_rows[d] = get_max_packed_rows(old_owners2new_ents[d]);
+  }
+  comm->allreduce(max_packed_rows, dim + 1, OMEGA_H_MAX);
   for (Int d = dim; d > VERT; --d) {
-    Adj high2low;
-    Dist old_low_owners2new_lows;
-    push_down(old_mesh, d, d - 1, old_owners2new_ents, high2low,
-        old_low_owners2new_lows);
-    new_mesh->set_ents(d, high2low);
-    new_ents2old_owners = old_owners2new_ents.invert();
-    push_ents(
-        old_mesh, new_mesh, d, new_ents2old_owners, old_owners2new_ents, mode);
-    old_owners2new_ents = old_low_owners2new_lows;
+    new_mesh->set_ents(d, new_ents2new_lows[d]);
+    push_ents(old_mesh, new_mesh, d, old_owners2new_ents[d].invert(),
+        old_owners2new_ents[d], mode, max_packed_rows[d]);
   }
-  auto new_verts2old_owners = old_owners2new_ents.invert();
+  auto new_verts2old_owners = old_owners2new_ents[VERT].invert();
   auto nnew_verts = new_verts2old_owners.nitems();
   new_mesh->set_verts(nnew_verts);
-  push_ents(old_mesh, new_mesh, VERT, new_verts2old_owners, old_owners2new_ents,
-      mode);
+  push_ents(old_mesh, new_mesh, VERT, new_verts2old_owners,
+      old_owners2new_ents[VERT], mode, max_packed_rows[VERT]);
 }
 
 void migrate_mesh(Mesh* mesh, Dist new_elems2old_owners, bool verbose) {
@@ -28,11 +28,14 @@ void push_down(Mesh* old_mesh, Int ent_dim, Int low_dim,
     Dist old_owners2new_ents, Adj& new_ents2new_lows,
     Dist& old_low_owners2new_lows);
 
+/* max_nents bounds the packed tag arrays on every rank,
+   see get_max_packed_rows */
 void push_tags(Mesh const* old_mesh, Mesh* new_mesh, Int ent_dim,
-    Dist old_owners2new_ents);
+    Dist old_owners2new_ents, GO max_nents);
 
 void push_ents(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
-    Dist new_ents2old_owners, Dist old_owners2new_ents, Omega_h_Parting mode);
+    Dist new_ents2old_owners, Dist old_owners2new_ents, Omega_h_Parting mode,
+    GO max_packed_rows);
 
 void migrate_mesh(Mesh* old_mesh, Mesh* new_mesh, Dist new_elems2old_owners,
     Omega_h_Parting mode, bool verbose);
@@ -61,6 +61,17 @@ static void test_two_ranks_dist(CommPtr comm) {
   }
   auto c = dist.invert().exch(b, 1);
   CHECK(c == a);
+  /* two split exchanges in flight at once */
+  auto ex_a = dist.exch_start(a, 1);
+  auto ex_b = dist.exch_start(multiply_each_by(2.0, a), 1);
+  CHECK(dist.exch_finish(ex_b) == multiply_each_by(2.0, b));
+  CHECK(dist.exch_finish(ex_a) == b);
+  /* a second width uses its own cached plan, and copies
+     of the inverse share theirs */
+  Reals a2 = Read<Real>(2 * a.size(), 0.0, 1.0);
+  auto b2 = dist.exch(a2, 2);
+  CHECK(dist.invert().exch(b2, 2) == a2);
+  CHECK(dist.invert().exch(b, 1) == a);
 }
 
 static void test_two_ranks_eq_owners(CommPtr comm) {
@@ -207,6 +218,37 @@ static void test_read_vtu(Library* lib, CommPtr comm) {
   CHECK(OMEGA_H_SAME == compare_meshes(&mesh0, &mesh1, 0.0, 0.0, true, false));
 }
 
+static void test_sync_tags(Library* lib, CommPtr comm) {
+  Mesh mesh(lib);
+  if (comm->rank() == 0) {
+    build_box(&mesh, 1, 1, 0, 4, 4, 0);
+  }
+  mesh.set_comm(comm);
+  mesh.balance();
+  mesh.set_parting(OMEGA_H_GHOSTED);
+  auto owned = mesh.owned(VERT);
+  auto globals = mesh.ask_globals(VERT);
+  auto coords = mesh.coords();
+  Write<I32> a(mesh.nverts());
+  Write<Real> b(mesh.nverts() * 2);
+  auto f = LAMBDA(LO v) {
+    a[v] = owned[v] ? I32(globals[v] % 7) : -1;
+    b[v * 2 + 0] = owned[v] ? coords[v * 2 + 0] : -1.0;
+    b[v * 2 + 1] = owned[v] ? coords[v * 2 + 1] : -1.0;
+  };
+  parallel_for(mesh.nverts(), f);
+  mesh.add_tag(VERT, "a", 1, OMEGA_H_DONT_TRANSFER, OMEGA_H_DONT_OUTPUT,
+      Read<I32>(a));
+  mesh.add_tag(VERT, "b", 2, OMEGA_H_DONT_TRANSFER, OMEGA_H_DONT_OUTPUT,
+      Reals(b));
+  mesh.sync_tags(VERT, {"a", "b"});
+  Write<I32> a_expected(mesh.nverts());
+  auto g = LAMBDA(LO v) { a_expected[v] = I32(globals[v] % 7); };
+  parallel_for(mesh.nverts(), g);
+  CHECK(mesh.get_array<I32>(VERT, "a") == Read<I32>(a_expected));
+  CHECK(mesh.get_array<Real>(VERT, "b") == coords);
+}
+
 static void test_two_ranks(Library* lib, CommPtr comm) {
   test_two_ranks_dist(comm);
   test_two_ranks_owners(comm);
@@ -215,6 +257,64 @@ static void test_two_ranks(Library* lib, CommPtr comm) {
   test_resolve_derived(comm);
   test_construct(lib, comm);
   test_read_vtu(lib, comm);
+  test_sync_tags(lib, comm);
+}
+
+static void test_allreduce_batch(CommPtr comm) {
+  auto rank = comm->rank();
+  auto size = comm->size();
+  AllreduceBatch batch;
+  auto min_slot = batch.add(Real(rank) + 0.5, OMEGA_H_MIN);
+  auto max_slot = batch.add(Real(rank) + 0.5, OMEGA_H_MAX);
+  auto sum_slot = batch.add(GO(rank + 1), OMEGA_H_SUM);
+  auto max_int_slot = batch.add(GO(-rank), OMEGA_H_MAX);
+  comm->allreduce(batch);
+  CHECK(batch.get_real(min_slot) == 0.5);
+  CHECK(batch.get_real(max_slot) == Real(size) - 0.5);
+  CHECK(batch.get_integer(sum_slot) == GO(size) * GO(size + 1) / 2);
+  CHECK(batch.get_integer(max_int_slot) == 0);
+}
+
+static void test_iallreduce(CommPtr comm) {
+  auto size = comm->size();
+  auto sum_request = comm->iallreduce(comm->rank(), OMEGA_H_SUM);
+  auto max_request = comm->iallreduce(Real(comm->rank()), OMEGA_H_MAX);
+  /* copies of a request share the value being reduced */
+  auto copy = sum_request;
+  CHECK(comm->wait(max_request) == Real(size - 1));
+  CHECK(comm->wait(copy) == size * (size - 1) / 2);
+}
+
+static void test_node_aware(CommPtr comm) {
+  /* every rank sends one item to every rank, so with nodes of
+     two ranks the leaders can merge messages */
+  auto rank = comm->rank();
+  auto size = comm->size();
+  Dist dist(comm, Remotes(Read<I32>(size, 0, 1), LOs(size, rank)), size);
+  Write<I32> a(size);
+  for (I32 i = 0; i < size; ++i) a.set(i, rank * size + i);
+  Write<I32> expected(size);
+  for (I32 i = 0; i < size; ++i) expected.set(i, i * size + rank);
+  reset_messages_sent();
+  CHECK(dist.exch(Read<I32>(a), 1) == Read<I32>(expected));
+  auto flat_messages = comm->allreduce(I32(get_messages_sent()), OMEGA_H_SUM);
+  set_node_aware_exchanges(true, 2);
+  /* construction exchanges directly, the hierarchy waits for
+     the first exchange of data */
+  reset_messages_sent();
+  dist = Dist(comm, Remotes(Read<I32>(size, 0, 1), LOs(size, rank)), size);
+  auto construct_messages =
+      comm->allreduce(I32(get_messages_sent()), OMEGA_H_SUM);
+  CHECK(construct_messages == flat_messages);
+  CHECK(dist.exch(Read<I32>(a), 1) == Read<I32>(expected));
+  reset_messages_sent();
+  CHECK(dist.exch(Read<I32>(a), 1) == Read<I32>(expected));
+  auto node_messages = comm->allreduce(I32(get_messages_sent()), OMEGA_H_SUM);
+  set_node_aware_exchanges(false);
+  CHECK(flat_messages == size * (size - 1));
+  /* a node of one rank gains nothing from forwarding, e.g. with
+     three ranks both routes send six messages */
+  if (size % 2 == 0 && size > 2) CHECK(node_messages < flat_messages);
 }
 
 static void test_rib(CommPtr comm) {
@@ -231,12 +331,21 @@ static void test_rib(CommPtr comm) {
   auto owners = Remotes(Read<I32>(n, rank), LOs(n, 0, 1));
   auto out = inertia::recursively_bisect(
       comm, coords, masses, owners, 0.01, inertia::Rib());
-  I32 size2 = 1;
   for (auto axis : out.axes) {
     CHECK(are_close(axis, vector_3(1, 0, 0)));
-    size2 *= 2;
   }
-  CHECK(size2 == size);
+  /* each bisection gives the lower size / 2 ranks to one side */
+  I32 depth = 0;
+  for (I32 first = 0, nranks = size; nranks > 1; ++depth) {
+    auto nlow = nranks / 2;
+    if (rank < first + nlow) {
+      nranks = nlow;
+    } else {
+      first += nlow;
+      nranks -= nlow;
+    }
+  }
+  CHECK(I32(out.axes.size()) == depth);
   auto check_coords = LAMBDA(LO i) {
     auto v = get_vector<3>(coords, i);
     CHECK(rank * n <= v[0]);
@@ -247,6 +356,94 @@ static void test_rib(CommPtr comm) {
   CHECK(masses == Reals(n, 1));
 }
 
+static void test_graph_balance(Library* lib, CommPtr comm) {
+  /* a curved strip, which straight bisections cut at an angle */
+  Mesh rib_mesh(lib);
+  if (comm->rank() == 0) {
+    build_box(&rib_mesh, 1, 1, 0, 32, 8, 0);
+    auto coords = rib_mesh.coords();
+    Write<Real> curved(coords.size());
+    auto f = LAMBDA(LO v) {
+      auto x = get_vector<2>(coords, v);
+      auto r = 1.0 + 0.3 * x[1];
+      auto a = 1.5 * PI * x[0] * x[0];
+      set_vector(curved, v, vector_2(r * cos(a), r * sin(a)));
+    };
+    parallel_for(rib_mesh.nverts(), f);
+    rib_mesh.set_coords(curved);
+  }
+  rib_mesh.set_comm(comm);
+  auto graph_mesh = rib_mesh;
+  rib_mesh.balance();
+  graph_mesh.balance(false, OMEGA_H_GRAPH);
+  auto rib_stats = get_partition_stats(&rib_mesh);
+  auto graph_stats = get_partition_stats(
+      &graph_mesh, get_balance_masses(&graph_mesh, false));
+  CHECK(graph_stats.cut_sides <= rib_stats.cut_sides);
+  CHECK(graph_stats.mass_imbalance <=
+        max2(rib_stats.mass_imbalance, 1.05) + 1e-10);
+  CHECK(are_close(graph_stats.mass_imbalance, graph_stats.imbalance));
+  CHECK(OMEGA_H_SAME ==
+        compare_meshes(&rib_mesh, &graph_mesh, 0.0, 0.0, true, false));
+}
+
+static void test_hilbert_balance(Library* lib, CommPtr comm, Int dim) {
+  Mesh rib_mesh(lib);
+  if (comm->rank() == 0) {
+    auto nz = (dim == 3) ? 6 : 0;
+    build_box(&rib_mesh, 1, 1, nz ? 1 : 0, 12, 12, nz);
+  }
+  rib_mesh.set_comm(comm);
+  auto hilbert_mesh = rib_mesh;
+  rib_mesh.balance();
+  hilbert_mesh.balance(false, OMEGA_H_HILBERT);
+  CHECK(hilbert_mesh.nelems() > 0);
+  auto stats = get_partition_stats(&hilbert_mesh);
+  CHECK(stats.imbalance < 1.05);
+  CHECK(OMEGA_H_SAME ==
+        compare_meshes(&rib_mesh, &hilbert_mesh, 0.0, 0.0, true, false));
+}
+
+static void test_merge_parts(Library* lib, CommPtr comm) {
+  Mesh mesh(lib);
+  if (comm->rank() == 0) {
+    build_box(&mesh, 1, 1, 0, 8, 8, 0);
+  }
+  mesh.set_comm(comm);
+  mesh.balance();
+  auto nparts = comm->size() - 1;
+  mesh.merge_parts(nparts);
+  auto is_out = (comm->rank() < nparts);
+  auto out = comm->split(I32(is_out), 0);
+  if (!is_out) {
+    CHECK(mesh.nelems() == 0);
+    return;
+  }
+  mesh.set_comm(out);
+  CHECK(mesh.nglobal_ents(mesh.dim()) == 128);
+  mesh.balance();
+  Mesh expected(lib);
+  if (out->rank() == 0) {
+    build_box(&expected, 1, 1, 0, 8, 8, 0);
+  }
+  expected.set_comm(out);
+  expected.balance();
+  CHECK(OMEGA_H_SAME ==
+        compare_meshes(&expected, &mesh, 0.0, 0.0, true, false));
+}
+
+static void test_three_ranks_balance(Library* lib, CommPtr comm) {
+  Mesh mesh(lib);
+  if (comm->rank() == 0) {
+    build_box(&mesh, 1, 1, 0, 6, 6, 0);
+  }
+  mesh.set_comm(comm);
+  mesh.balance();
+  CHECK(mesh.nelems() > 0);
+  auto stats = get_partition_stats(&mesh);
+  CHECK(stats.imbalance < 1.2);
+}
+
 int main(int argc, char** argv) {
   auto lib = Library(&argc, &argv);
   auto world = lib.world();
@@ -265,4 +462,18 @@ int main(int argc, char** argv) {
     }
   }
   test_rib(world);
+  if (world->size() >= 3) {
+    auto three = world->split(world->rank() / 3, world->rank() % 3);
+    if (world->rank() / 3 == 0) {
+      test_rib(three);
+      test_three_ranks_balance(&lib, three);
+    }
+  }
+  test_allreduce_batch(world);
+  test_iallreduce(world);
+  test_node_aware(world);
+  test_graph_balance(&lib, world);
+  test_hilbert_balance(&lib, world, 2);
+  test_hilbert_balance(&lib, world, 3);
+  if (world->size() >= 2) test_merge_parts(&lib, world);
 }
@@ -5,9 +5,10 @@
 int main(int argc, char** argv) {
   auto lib = Omega_h::Library(&argc, &argv);
   auto world = lib.world();
-  if (argc != 4) {
+  if (argc != 4 && argc != 5) {
     if (!world->rank()) {
-      std::cout << "usage: " << argv[0] << " in.osh <nparts> out.osh\n";
+      std::cout << "usage: " << argv[0]
+                << " in.osh <nparts> out.osh [rib|graph|hilbert]\n";
     }
     return -1;
   }
@@ -15,6 +16,20 @@ int main(int argc, char** argv) {
   auto path_in = argv[1];
   auto nparts_out = atoi(argv[2]);
   auto path_out = argv[3];
+  auto partitioner = OMEGA_H_RIB;
+  if (argc == 5) {
+    std::string name = argv[4];
+    if (name == "graph") {
+      partitioner = OMEGA_H_GRAPH;
+    } else if (name == "hilbert") {
+      partitioner = OMEGA_H_HILBERT;
+    } else if (name != "rib") {
+      if (!world->rank()) {
+        std::cout << "error: unknown partitioner " << name << '\n';
+      }
+      return -1;
+    }
+  }
   auto t0 = Omega_h::now();
   if (nparts_out < 1) {
     if (!world->rank()) {
@@ -44,14 +59,18 @@ int main(int argc, char** argv) {
   auto mesh = Omega_h::Mesh(&lib);
   if (is_in) {
     Omega_h::binary::read_in_comm(path_in, comm_in, &mesh);
-    if (nparts_out < nparts_in) {
-      Omega_h_fail(
-          "partitioning to a smaller part count not yet implemented\n");
-    }
+    if (nparts_out < nparts_in) mesh.merge_parts(nparts_out);
   }
-  if (is_in || is_out) mesh.set_comm(comm_out);
+  /* when shrinking, the ranks beyond nparts_out are now empty
+     and drop out; when growing, set_comm() spreads the mesh */
+  if (is_out) mesh.set_comm(comm_out);
   if (is_out) {
-    if (nparts_out != nparts_in) mesh.balance();
+    if (nparts_out != nparts_in) mesh.balance(false, partitioner);
+    auto stats = Omega_h::get_partition_stats(&mesh);
+    if (!comm_out->rank()) {
+      std::cout << "partition cuts " << stats.cut_sides
+                << " sides, imbalance " << stats.imbalance << '\n';
+    }
     Omega_h::binary::write(path_out, &mesh);
   }
   world->barrier();
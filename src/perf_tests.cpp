@@ -10,6 +10,7 @@
 #include "internal.hpp"
 #include "loop.hpp"
 #include "metric.hpp"
+#include "reorder.hpp"
 #include "sort.hpp"
 #include "space.hpp"
 #include "timer.hpp"
@@ -157,11 +158,21 @@ static void test_sort_n(Int width) {
   LOs a = random_ints<LO>(nelems * width, 0, nelems);
   LOs perm;
   Int niters = 5;
-  Now t0 = now();
-  for (Int i = 0; i < niters; ++i) perm = sort_by_keys(a, width);
-  Now t1 = now();
-  std::cout << "sorting " << nelems << " sets of " << width << " integers "
-            << niters << " times takes " << (t1 - t0) << " seconds\n";
+  {
+    Now t0 = now();
+    for (Int i = 0; i < niters; ++i) perm = sort_by_keys(a, width);
+    Now t1 = now();
+    std::cout << "sorting " << nelems << " sets of " << width << " integers "
+              << niters << " times takes " << (t1 - t0) << " seconds\n";
+  }
+  {
+    Now t0 = now();
+    for (Int i = 0; i < niters; ++i) perm = comparison_sort_by_keys(a, width);
+    Now t1 = now();
+    std::cout << "comparison sorting " << nelems << " sets of " << width
+              << " integers " << niters << " times takes " << (t1 - t0)
+              << " seconds\n";
+  }
 }
 
 static void test_sort() {
@@ -219,6 +230,14 @@ static void test_adjs(Library* lib) {
     std::cout << "reordering a " << mesh.nelems() << " tet mesh took "
               << (t1 - t0) << " seconds\n";
   }
+  {
+    Now t0 = now();
+    reorder_by_hilbert(&mesh, 63);
+    Now t1 = now();
+    std::cout << "reordering a " << mesh.nelems()
+              << " tet mesh by a 63-bit Hilbert index took " << (t1 - t0)
+              << " seconds\n";
+  }
   LOs tets2verts;
   LOs tris2verts;
   {
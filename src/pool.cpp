@@ -0,0 +1,134 @@
+#include "pool.hpp"
+
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace Omega_h {
+
+namespace pool {
+
+static std::size_t const min_block_bytes = 256;
+
+/* below min_block_bytes everything shares one bucket,
+   above it each power of two is split into 8 buckets,
+   wasting at most 12.5% of a block */
+static std::size_t round_up(std::size_t bytes) {
+  if (bytes <= min_block_bytes) return min_block_bytes;
+  std::size_t octave = 1;
+  while (octave < bytes) octave <<= 1;
+  std::size_t step = octave / 16;
+  return ((bytes + step - 1) / step) * step;
+}
+
+struct Pool {
+  std::mutex mutex;
+  std::map<std::size_t, std::vector<void*>> free_blocks;
+  std::size_t cached_bytes = 0;
+  std::size_t used_bytes = 0;
+  std::size_t max_used_bytes = 0;
+  /* zero means the cap is a quarter of the high-water mark of
+     bytes handed out by the pool, so that the cache adds at
+     most 25% to the peak memory of the process */
+  std::size_t max_cached_bytes = 0;
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t cap() const {
+    return max_cached_bytes ? max_cached_bytes : max_used_bytes / 4;
+  }
+  void release_cached(std::size_t target_bytes) {
+    auto it = free_blocks.end();
+    /* release the largest blocks first */
+    while (cached_bytes > target_bytes && it != free_blocks.begin()) {
+      --it;
+      auto& blocks = it->second;
+      while (cached_bytes > target_bytes && !blocks.empty()) {
+        ::operator delete(blocks.back());
+        blocks.pop_back();
+        cached_bytes -= it->first;
+      }
+    }
+  }
+};
+
+/* never destroyed, since arrays may outlive static destructors */
+static Pool* get_pool() {
+  static Pool* pool = new Pool();
+  return pool;
+}
+
+void* allocate(std::size_t bytes) {
+  auto rounded = round_up(bytes);
+  auto pool = get_pool();
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->used_bytes += rounded;
+    pool->max_used_bytes = max2(pool->max_used_bytes, pool->used_bytes);
+    auto it = pool->free_blocks.find(rounded);
+    if (it != pool->free_blocks.end() && !it->second.empty()) {
+      auto ptr = it->second.back();
+      it->second.pop_back();
+      pool->cached_bytes -= rounded;
+      ++(pool->hits);
+      return ptr;
+    }
+    ++(pool->misses);
+  }
+  try {
+    return ::operator new(rounded);
+  } catch (std::bad_alloc const&) {
+    trim_pool();
+    return ::operator new(rounded);
+  }
+}
+
+void deallocate(void* ptr, std::size_t bytes) {
+  auto rounded = round_up(bytes);
+  auto pool = get_pool();
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  pool->used_bytes -= rounded;
+  auto cap = pool->cap();
+  if (rounded > cap) {
+    ::operator delete(ptr);
+    return;
+  }
+  if (pool->cached_bytes + rounded > cap) pool->release_cached(cap - rounded);
+  pool->free_blocks[rounded].push_back(ptr);
+  pool->cached_bytes += rounded;
+}
+
+}  // end namespace pool
+
+std::size_t get_pool_hits() {
+  auto pool = pool::get_pool();
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  return pool->hits;
+}
+
+std::size_t get_pool_misses() {
+  auto pool = pool::get_pool();
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  return pool->misses;
+}
+
+std::size_t get_pool_cached_bytes() {
+  auto pool = pool::get_pool();
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  return pool->cached_bytes;
+}
+
+void set_pool_max_cached_bytes(std::size_t max_bytes) {
+  auto pool = pool::get_pool();
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  pool->max_cached_bytes = max_bytes;
+  pool->release_cached(pool->cap());
+}
+
+void trim_pool() {
+  auto pool = pool::get_pool();
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  pool->release_cached(0);
+}
+
+}  // end namespace Omega_h
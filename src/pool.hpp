@@ -0,0 +1,21 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include "internal.hpp"
+
+namespace Omega_h {
+
+/* a size-bucketed cache of host allocations backing Write<T>.
+   freed blocks are kept on a free list for their rounded size
+   and handed back out to later allocations of the same bucket,
+   as long as the total cached bytes stay under a cap. */
+namespace pool {
+
+void* allocate(std::size_t bytes);
+void deallocate(void* ptr, std::size_t bytes);
+
+}  // end namespace pool
+
+}  // end namespace Omega_h
+
+#endif
@@ -24,7 +24,8 @@ static bool refine_ghosted(Mesh* mesh, AdaptOpts const& opts) {
   auto edges_are_initial =
       map_onto(cands_are_good, cands2edges, nedges, I8(0), 1);
   auto edge_quals = map_onto(cand_quals, cands2edges, nedges, 0.0, 1);
-  auto edges_are_keys = find_indset(mesh, EDGE, edge_quals, edges_are_initial);
+  auto edges_are_keys = find_indset(
+      mesh, EDGE, edge_quals, edges_are_initial, opts.indset_strategy);
   mesh->add_tag(EDGE, "key", 1, OMEGA_H_DONT_TRANSFER, OMEGA_H_DONT_OUTPUT,
       edges_are_keys);
   if (mesh->keeps_canonical_globals()) {
@@ -85,6 +86,8 @@ static bool refine(Mesh* mesh, AdaptOpts const& opts) {
 }
 
 bool refine_by_size(Mesh* mesh, AdaptOpts const& opts) {
+  MemoryLabel label("refine");
+  CommRegion region("refine");
   auto comm = mesh->comm();
   auto lengths = mesh->ask_lengths();
   auto edge_is_cand = each_gt(lengths, opts.max_length_desired);
@@ -61,4 +61,10 @@ void reorder_by_hilbert(Mesh* mesh) {
   reorder_mesh(mesh, new_verts2old_verts);
 }
 
+void reorder_by_hilbert(Mesh* mesh, Int nbits) {
+  auto coords = mesh->coords();
+  LOs new_verts2old_verts = hilbert::sort_coords(coords, mesh->dim(), nbits);
+  reorder_mesh(mesh, new_verts2old_verts);
+}
+
 }  // end namespace Omega_h
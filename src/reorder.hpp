@@ -10,6 +10,8 @@ LOs ent_order_from_vert_order(Mesh* mesh, Int ent_dim, LOs new_vert2old_vert);
 void reorder_mesh(Mesh* old_mesh, Mesh* new_mesh, LOs new_verts2old_verts);
 void reorder_mesh(Mesh* mesh, LOs new_verts2old_verts);
 void reorder_by_hilbert(Mesh* mesh);
+/* coarser but cheaper, see hilbert::sort_coords */
+void reorder_by_hilbert(Mesh* mesh, Int nbits);
 
 }  // end namespace Omega_h
 
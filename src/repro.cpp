@@ -78,7 +78,89 @@ Real repro_sum(CommPtr comm, Reals a) {
   return fixpt_sum.to_double(unit);
 }
 
+/* the multi-component versions make one pass over the
+   interleaved values for the exponents and one for the sums,
+   and need one allreduce for each rather than two per component */
+
+template <Int ncomps>
+struct MaxExponents {
+  typedef Few<I64, ncomps> value_type;
+  Reals a_;
+  MaxExponents(Reals a) : a_(a) {}
+  INLINE void init(value_type& update) const {
+    for (Int c = 0; c < ncomps; ++c) update[c] = ArithTraits<int>::min();
+  }
+  INLINE void join(
+      volatile value_type& update, const volatile value_type& input) const {
+    value_type joined = update;
+    value_type other = input;
+    for (Int c = 0; c < ncomps; ++c) joined[c] = max2(joined[c], other[c]);
+    update = joined;
+  }
+  DEVICE void operator()(Int i, value_type& update) const {
+    for (Int c = 0; c < ncomps; ++c) {
+      int expo;
+      frexp(a_[i * ncomps + c], &expo);
+      if (expo > update[c]) update[c] = expo;
+    }
+  }
+};
+
+template <Int ncomps>
+struct ReproSums {
+  typedef Few<Int128, ncomps> value_type;
+  Reals a_;
+  Few<double, ncomps> units_;
+  ReproSums(Reals a, Few<double, ncomps> units) : a_(a), units_(units) {}
+  INLINE void init(value_type& update) const {
+    for (Int c = 0; c < ncomps; ++c) update[c] = Int128(0);
+  }
+  INLINE void join(
+      volatile value_type& update, const volatile value_type& input) const {
+    for (Int c = 0; c < ncomps; ++c) {
+      update[c] = Int128(update[c]) + Int128(input[c]);
+    }
+  }
+  DEVICE void operator()(Int i, value_type& update) const {
+    for (Int c = 0; c < ncomps; ++c) {
+      update[c] =
+          update[c] + Int128::from_double(a_[i * ncomps + c], units_[c]);
+    }
+  }
+};
+
+template <Int ncomps>
+static void repro_sum_tmpl(CommPtr comm, Reals a, Real result[]) {
+  auto n = a.size() / ncomps;
+  auto expos = parallel_reduce(n, MaxExponents<ncomps>(a));
+  comm->allreduce(expos.data(), ncomps, OMEGA_H_MAX);
+  Few<double, ncomps> units;
+  for (Int c = 0; c < ncomps; ++c) {
+    units[c] = exp2(double(expos[c] - MANTISSA_BITS));
+  }
+  auto fixpt_sums = parallel_reduce(n, ReproSums<ncomps>(a, units));
+  comm->add_int128(fixpt_sums.data(), ncomps);
+  for (Int c = 0; c < ncomps; ++c) {
+    result[c] = fixpt_sums[c].to_double(units[c]);
+  }
+}
+
 void repro_sum(CommPtr comm, Reals a, Int ncomps, Real result[]) {
+  CHECK(a.size() % ncomps == 0);
+  switch (ncomps) {
+    case 1:
+      result[0] = repro_sum(comm, a);
+      return;
+    case 2:
+      repro_sum_tmpl<2>(comm, a, result);
+      return;
+    case 3:
+      repro_sum_tmpl<3>(comm, a, result);
+      return;
+    case 6:
+      repro_sum_tmpl<6>(comm, a, result);
+      return;
+  }
   for (Int comp = 0; comp < ncomps; ++comp) {
     result[comp] = repro_sum(comm, get_component(a, ncomps, comp));
   }
@@ -0,0 +1,104 @@
+#include "sfcpart.hpp"
+
+#include <algorithm>
+
+#include "Omega_h_math.hpp"
+#include "hilbert.hpp"
+#include "loop.hpp"
+#include "map.hpp"
+#include "sort.hpp"
+
+namespace Omega_h {
+
+/* finds, for each of the (nparts - 1) cuts, the smallest key
+   such that the points with lower keys hold about the fraction
+   of the total mass that belongs before that cut */
+static std::vector<I64> find_splitters(
+    CommPtr comm, Read<I64> keys, Reals masses, Real tolerance) {
+  auto nparts = comm->size();
+  auto nsplits = std::size_t(nparts - 1);
+  auto order = sort_by_keys(keys);
+  auto sorted_keys = HostRead<I64>(unmap(order, keys, 1));
+  auto sorted_masses = HostRead<Real>(unmap(order, masses, 1));
+  auto n = sorted_keys.size();
+  /* prefix[i] is the mass of the first i local points in key order */
+  std::vector<Real> prefix(std::size_t(n + 1), 0.0);
+  for (LO i = 0; i < n; ++i) {
+    prefix[std::size_t(i + 1)] = prefix[std::size_t(i)] + sorted_masses[i];
+  }
+  auto total_mass = comm->allreduce(prefix[std::size_t(n)], OMEGA_H_SUM);
+  auto max_error = tolerance * total_mass / Real(nparts);
+  auto keys_begin = sorted_keys.data();
+  auto keys_end = keys_begin + n;
+  std::vector<I64> lows(nsplits, 0);
+  std::vector<I64> highs(nsplits, ArithTraits<I64>::max());
+  std::vector<I64> splits(nsplits, 0);
+  std::vector<Real> masses_below(nsplits, 0.0);
+  std::vector<bool> done(nsplits, false);
+  std::size_t ndone = 0;
+  while (ndone < nsplits) {
+    for (std::size_t k = 0; k < nsplits; ++k) {
+      if (!done[k]) splits[k] = lows[k] + (highs[k] - lows[k]) / 2;
+      auto nbelow = std::lower_bound(keys_begin, keys_end, splits[k]) -
+                    keys_begin;
+      masses_below[k] = prefix[std::size_t(nbelow)];
+    }
+    comm->allreduce(masses_below.data(), Int(nsplits), OMEGA_H_SUM);
+    for (std::size_t k = 0; k < nsplits; ++k) {
+      if (done[k]) continue;
+      auto target = total_mass * Real(k + 1) / Real(nparts);
+      /* once the range is down to one key, equal keys
+         can't be split any further */
+      if (fabs(masses_below[k] - target) <= max_error ||
+          highs[k] - lows[k] <= 1) {
+        done[k] = true;
+        ++ndone;
+      } else if (masses_below[k] < target) {
+        lows[k] = splits[k];
+      } else {
+        highs[k] = splits[k];
+      }
+    }
+  }
+  /* within the tolerance, two cuts could come out of order */
+  for (std::size_t k = 1; k < nsplits; ++k) {
+    splits[k] = max2(splits[k], splits[k - 1]);
+  }
+  return splits;
+}
+
+Read<I32> get_hilbert_parts(
+    CommPtr comm, Reals coords, Int dim, Reals masses, Real tolerance) {
+  CHECK(coords.size() == masses.size() * dim);
+  auto npts = masses.size();
+  if (comm->size() == 1) return Read<I32>(npts, 0);
+  /* one word per point, with as many bits per axis as fit */
+  auto nbits = hilbert::word_bits;
+  CHECK(hilbert::get_packed_width(dim, nbits) == 1);
+  auto keys = hilbert::packed_dists_from_coords(comm, coords, dim, nbits);
+  auto splits_h = find_splitters(comm, keys, masses, tolerance);
+  auto nsplits = LO(splits_h.size());
+  HostWrite<I64> splits_w(nsplits);
+  for (LO k = 0; k < nsplits; ++k) splits_w[k] = splits_h[std::size_t(k)];
+  auto splits = Read<I64>(splits_w.write());
+  Write<I32> parts(npts);
+  /* a point's part is the number of splitters at or below its key */
+  auto f = LAMBDA(LO i) {
+    auto key = keys[i];
+    LO lo = 0;
+    LO hi = nsplits;
+    while (lo < hi) {
+      auto mid = (lo + hi) / 2;
+      if (splits[mid] <= key) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    parts[i] = lo;
+  };
+  parallel_for(npts, f);
+  return parts;
+}
+
+}  // end namespace Omega_h
@@ -0,0 +1,23 @@
+#ifndef SFCPART_HPP
+#define SFCPART_HPP
+
+#include "internal.hpp"
+
+namespace Omega_h {
+
+/* partitions points by cutting a Hilbert curve through the
+   bounding box of all the points into (comm->size()) pieces
+   of nearly equal mass.
+   the pieces are separated by splitter keys, which are found
+   by bisecting the key range for all of them at once, with one
+   reduction per round.
+   a splitter is accepted once the mass before it is within
+   (tolerance) times the average part mass of its target.
+   returns the rank each point should move to */
+
+Read<I32> get_hilbert_parts(
+    CommPtr comm, Reals coords, Int dim, Reals masses, Real tolerance);
+
+}  // end namespace Omega_h
+
+#endif
@@ -1,6 +1,10 @@
 #include "sort.hpp"
 
 #include <algorithm>
+#include <vector>
+
+#include "Omega_h_math.hpp"
+#include "loop.hpp"
 
 #if defined(OMEGA_H_USE_CUDA)
 #ifdef __GNUC__
@@ -61,7 +65,7 @@ static LOs sort_by_keys_tmpl(Read<T> keys) {
 }
 
 template <typename T>
-LOs sort_by_keys(Read<T> keys, Int width) {
+LOs comparison_sort_by_keys(Read<T> keys, Int width) {
   switch (width) {
     case 1:
       return sort_by_keys_tmpl<1>(keys);
@@ -73,7 +77,197 @@ LOs sort_by_keys(Read<T> keys, Int width) {
   NORETURN(LOs());
 }
 
-#define INST(T) template LOs sort_by_keys(Read<T> keys, Int width);
+#ifndef OMEGA_H_USE_CUDA
+
+/* the radix sort works on host memory through raw pointers.
+   the array is cut into fixed-size blocks which are
+   histogrammed and scattered in parallel; the block
+   size does not depend on the thread count, so the
+   result is the same for any number of threads. */
+
+typedef std::uint64_t U64;
+
+enum { RADIX_BITS = 8, RADIX = 1 << RADIX_BITS };
+
+static LO const radix_block_size = 64 * 1024;
+
+static Int bit_width(U64 x) {
+  Int nbits = 0;
+  while (x) {
+    ++nbits;
+    x >>= 1;
+  }
+  return nbits;
+}
+
+/* stably sorts (vals, perm) pairs by the lowest nbits of vals */
+static void radix_sort_pairs(
+    std::vector<U64>& vals, std::vector<LO>& perm, Int nbits) {
+  LO n = static_cast<LO>(vals.size());
+  LO nblocks = (n + radix_block_size - 1) / radix_block_size;
+  std::vector<U64> vals2(vals.size());
+  std::vector<LO> perm2(perm.size());
+  std::vector<LO> offsets(static_cast<std::size_t>(nblocks * RADIX));
+  for (Int shift = 0; shift < nbits; shift += RADIX_BITS) {
+    U64 const* vals_in = vals.data();
+    LO const* perm_in = perm.data();
+    U64* vals_out = vals2.data();
+    LO* perm_out = perm2.data();
+    LO* counts = offsets.data();
+    auto count = LAMBDA(LO block) {
+      LO* block_counts = counts + block * RADIX;
+      for (Int d = 0; d < RADIX; ++d) block_counts[d] = 0;
+      LO end = min2(n, (block + 1) * radix_block_size);
+      for (LO i = block * radix_block_size; i < end; ++i) {
+        ++block_counts[(vals_in[i] >> shift) & (RADIX - 1)];
+      }
+    };
+    parallel_for(nblocks, count);
+    /* digit-major, block-minor exclusive scan keeps the sort stable */
+    bool is_trivial = false;
+    LO total = 0;
+    for (Int d = 0; d < RADIX; ++d) {
+      LO digit_total = 0;
+      for (LO block = 0; block < nblocks; ++block) {
+        LO c = counts[block * RADIX + d];
+        counts[block * RADIX + d] = total;
+        total += c;
+        digit_total += c;
+      }
+      if (digit_total == n) is_trivial = true;
+    }
+    /* every value has the same digit here, nothing moves */
+    if (is_trivial) continue;
+    auto scatter = LAMBDA(LO block) {
+      LO* block_offsets = counts + block * RADIX;
+      LO end = min2(n, (block + 1) * radix_block_size);
+      for (LO i = block * radix_block_size; i < end; ++i) {
+        auto j = block_offsets[(vals_in[i] >> shift) & (RADIX - 1)]++;
+        vals_out[j] = vals_in[i];
+        perm_out[j] = perm_in[i];
+      }
+    };
+    parallel_for(nblocks, scatter);
+    std::swap(vals, vals2);
+    std::swap(perm, perm2);
+  }
+}
+
+template <Int N, typename T>
+static LOs radix_sort_by_keys_tmpl(Read<T> keys) {
+  CHECK(keys.size() % N == 0);
+  LO n = keys.size() / N;
+  T const* keyptr = keys.data();
+  /* keys are offset by their minimum so that signed values
+     and small ranges need only as many bits as they span */
+  LO nblocks = (n + radix_block_size - 1) / radix_block_size;
+  std::vector<T> block_mins(static_cast<std::size_t>(nblocks * N));
+  std::vector<T> block_maxs(static_cast<std::size_t>(nblocks * N));
+  T* block_mins_ptr = block_mins.data();
+  T* block_maxs_ptr = block_maxs.data();
+  auto find_ranges = LAMBDA(LO block) {
+    LO begin = block * radix_block_size;
+    LO end = min2(n, begin + radix_block_size);
+    for (Int k = 0; k < N; ++k) {
+      T lo = keyptr[begin * N + k];
+      T hi = lo;
+      for (LO i = begin + 1; i < end; ++i) {
+        lo = min2(lo, keyptr[i * N + k]);
+        hi = max2(hi, keyptr[i * N + k]);
+      }
+      block_mins_ptr[block * N + k] = lo;
+      block_maxs_ptr[block * N + k] = hi;
+    }
+  };
+  parallel_for(nblocks, find_ranges);
+  Few<T, N> mins;
+  Int nbits[N];
+  Int total_bits = 0;
+  for (Int k = 0; k < N; ++k) {
+    mins[k] = ArithTraits<T>::max();
+    T maxk = ArithTraits<T>::min();
+    for (LO block = 0; block < nblocks; ++block) {
+      mins[k] = min2(mins[k], block_mins[std::size_t(block * N + k)]);
+      maxk = max2(maxk, block_maxs[std::size_t(block * N + k)]);
+    }
+    nbits[k] = n ? bit_width(U64(maxk) - U64(mins[k])) : 0;
+    total_bits += nbits[k];
+  }
+  std::vector<LO> perm(static_cast<std::size_t>(n));
+  std::vector<U64> vals(static_cast<std::size_t>(n));
+  LO* perm_ptr = perm.data();
+  U64* vals_ptr = vals.data();
+  auto init = LAMBDA(LO i) { perm_ptr[i] = i; };
+  parallel_for(n, init);
+  if (total_bits <= 64) {
+    /* pack all the keys of an item into one word, first key
+       most significant, and sort once */
+    auto pack = LAMBDA(LO i) {
+      U64 val = 0;
+      for (Int k = 0; k < N; ++k) {
+        if (!nbits[k]) continue;
+        U64 digit = U64(keyptr[i * N + k]) - U64(mins[k]);
+        val = (nbits[k] == 64) ? digit : ((val << nbits[k]) | digit);
+      }
+      vals_ptr[i] = val;
+    };
+    parallel_for(n, pack);
+    radix_sort_pairs(vals, perm, total_bits);
+  } else {
+    /* least significant key first, gathering it into
+       contiguous memory in the current order each time */
+    for (Int k = N - 1; k >= 0; --k) {
+      if (!nbits[k]) continue;
+      perm_ptr = perm.data();
+      vals_ptr = vals.data();
+      auto gather = LAMBDA(LO i) {
+        vals_ptr[i] = U64(keyptr[perm_ptr[i] * N + k]) - U64(mins[k]);
+      };
+      parallel_for(n, gather);
+      radix_sort_pairs(vals, perm, nbits[k]);
+    }
+  }
+  Write<LO> out(n);
+  perm_ptr = perm.data();
+  auto f = LAMBDA(LO i) { out[i] = perm_ptr[i]; };
+  parallel_for(n, f);
+  return out;
+}
+
+template <typename T>
+LOs radix_sort_by_keys(Read<T> keys, Int width) {
+  switch (width) {
+    case 1:
+      return radix_sort_by_keys_tmpl<1>(keys);
+    case 2:
+      return radix_sort_by_keys_tmpl<2>(keys);
+    case 3:
+      return radix_sort_by_keys_tmpl<3>(keys);
+  }
+  NORETURN(LOs());
+}
+
+#endif
+
+template <typename T>
+LOs sort_by_keys(Read<T> keys, Int width) {
+#ifdef OMEGA_H_USE_CUDA
+  return comparison_sort_by_keys(keys, width);
+#else
+  return radix_sort_by_keys(keys, width);
+#endif
+}
+
+#ifdef OMEGA_H_USE_CUDA
+#define INST(T)                                                                \
+  template LOs sort_by_keys(Read<T> keys, Int width);                          \
+  template LOs comparison_sort_by_keys(Read<T> keys, Int width);
+#else
+#define INST(T)                                                                \
+  template LOs sort_by_keys(Read<T> keys, Int width);                          \
+  template LOs comparison_sort_by_keys(Read<T> keys, Int width);               \
+  template LOs radix_sort_by_keys(Read<T> keys, Int width);
+#endif
 INST(LO)
 INST(GO)
 #undef INST
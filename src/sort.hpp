@@ -5,10 +5,31 @@
 
 namespace Omega_h {
 
+/* returns the permutation that stably sorts the
+   (width)-tuples of keys lexicographically.
+   host builds use radix_sort_by_keys, CUDA builds
+   use comparison_sort_by_keys */
 template <typename T>
 LOs sort_by_keys(Read<T> keys, Int width = 1);
 
-#define INST_DECL(T) extern template LOs sort_by_keys(Read<T> keys, Int width);
+template <typename T>
+LOs comparison_sort_by_keys(Read<T> keys, Int width = 1);
+
+#ifndef OMEGA_H_USE_CUDA
+template <typename T>
+LOs radix_sort_by_keys(Read<T> keys, Int width = 1);
+#endif
+
+#ifdef OMEGA_H_USE_CUDA
+#define INST_DECL(T)                                                           \
+  extern template LOs sort_by_keys(Read<T> keys, Int width);                   \
+  extern template LOs comparison_sort_by_keys(Read<T> keys, Int width);
+#else
+#define INST_DECL(T)                                                           \
+  extern template LOs sort_by_keys(Read<T> keys, Int width);                   \
+  extern template LOs comparison_sort_by_keys(Read<T> keys, Int width);        \
+  extern template LOs radix_sort_by_keys(Read<T> keys, Int width);
+#endif
 INST_DECL(LO)
 INST_DECL(GO)
 #undef INST_DECL
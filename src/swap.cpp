@@ -44,6 +44,8 @@ Read<I8> filter_swap_improve(Mesh* mesh, LOs cands2edges, Reals cand_quals) {
 }
 
 bool swap_edges(Mesh* mesh, AdaptOpts const& opts) {
+  MemoryLabel label("swap");
+  CommRegion region("swap");
   if (mesh->dim() == 3) return swap_edges_3d(mesh, opts);
   if (mesh->dim() == 2) return swap_edges_2d(mesh, opts);
   return false;
@@ -11,7 +11,7 @@
 
 namespace Omega_h {
 
-static bool swap2d_ghosted(Mesh* mesh) {
+static bool swap2d_ghosted(Mesh* mesh, AdaptOpts const& opts) {
   auto comm = mesh->comm();
   auto edges_are_cands = mesh->get_array<I8>(EDGE, "candidate");
   mesh->remove_tag(EDGE, "candidate");
@@ -27,14 +27,15 @@ static bool swap2d_ghosted(Mesh* mesh) {
   if (comm->reduce_and(cands2edges.size() == 0)) return false;
   edges_are_cands = mark_image(cands2edges, mesh->nedges());
   auto edge_quals = map_onto(cand_quals, cands2edges, mesh->nedges(), -1.0, 1);
-  auto edges_are_keys = find_indset(mesh, EDGE, edge_quals, edges_are_cands);
+  auto edges_are_keys = find_indset(
+      mesh, EDGE, edge_quals, edges_are_cands, opts.indset_strategy);
   Graph edges2cav_elems;
   if (needs_buffer_layers(mesh)) {
     edges2cav_elems = get_buffered_elems(mesh, EDGE, edges_are_keys);
     auto buf_conflicts =
         get_buffered_conflicts(mesh, EDGE, edges2cav_elems, edges_are_keys);
-    edges_are_keys =
-        find_indset(mesh, EDGE, buf_conflicts, edge_quals, edges_are_keys);
+    edges_are_keys = find_indset(mesh, EDGE, buf_conflicts, edge_quals,
+        edges_are_keys, opts.indset_strategy);
   } else {
     edges2cav_elems = mesh->ask_up(EDGE, mesh->dim());
   }
@@ -85,7 +86,7 @@ static void swap2d_element_based(Mesh* mesh, AdaptOpts const& opts) {
 
 bool swap_edges_2d(Mesh* mesh, AdaptOpts const& opts) {
   if (!swap_part1(mesh, opts)) return false;
-  if (!swap2d_ghosted(mesh)) return false;
+  if (!swap2d_ghosted(mesh, opts)) return false;
   mesh->set_parting(OMEGA_H_ELEM_BASED);
   swap2d_element_based(mesh, opts);
   return true;
@@ -1,5 +1,8 @@
 #include "tag.hpp"
 
+#include "Omega_h_math.hpp"
+#include "loop.hpp"
+
 namespace Omega_h {
 
 TagBase::TagBase(std::string const& name, Int ncomps, Int xfer, Int outflags)
@@ -74,6 +77,133 @@ Omega_h_Type Tag<T>::type() const {
   return TagTraits<T>::type();
 }
 
+static Int get_type_bytes(Omega_h_Type type) {
+  switch (type) {
+    case OMEGA_H_I8:
+      return Int(sizeof(I8));
+    case OMEGA_H_I32:
+      return Int(sizeof(I32));
+    case OMEGA_H_I64:
+      return Int(sizeof(I64));
+    case OMEGA_H_F64:
+      return Int(sizeof(Real));
+  }
+  NORETURN(0);
+}
+
+static Int get_ent_bytes(TagBase const* tag) {
+  return tag->ncomps() * get_type_bytes(tag->type());
+}
+
+static I8 const* get_tag_bytes(TagBase const* tag) {
+  switch (tag->type()) {
+    case OMEGA_H_I8:
+      return to<I8>(tag)->array().data();
+    case OMEGA_H_I32:
+      return reinterpret_cast<I8 const*>(to<I32>(tag)->array().data());
+    case OMEGA_H_I64:
+      return reinterpret_cast<I8 const*>(to<I64>(tag)->array().data());
+    case OMEGA_H_F64:
+      return reinterpret_cast<I8 const*>(to<Real>(tag)->array().data());
+  }
+  NORETURN(nullptr);
+}
+
+Int get_packed_row_bytes(std::vector<TagBase const*> const& tags) {
+  Int row_bytes = 0;
+  for (auto tag : tags) row_bytes += get_ent_bytes(tag);
+  return row_bytes;
+}
+
+bool can_pack_tags(std::vector<TagBase const*> const& tags, GO max_nents) {
+  auto nbytes = max_nents * GO(get_packed_row_bytes(tags));
+  return nbytes <= GO(ArithTraits<LO>::max());
+}
+
+GO get_max_packed_rows(Dist const& dist) {
+  return GO(max2(max2(dist.nsrcs(), dist.nitems()), dist.ndests()));
+}
+
+std::vector<std::vector<TagBase const*>> group_packable_tags(
+    std::vector<TagBase const*> const& tags, GO max_nents) {
+  std::vector<std::vector<TagBase const*>> groups;
+  std::vector<TagBase const*> group;
+  for (auto tag : tags) {
+    group.push_back(tag);
+    if (group.size() > 1 && !can_pack_tags(group, max_nents)) {
+      group.pop_back();
+      groups.push_back(group);
+      group.assign(1, tag);
+    }
+  }
+  if (!group.empty()) groups.push_back(group);
+  return groups;
+}
+
+Read<I8> pack_tags(std::vector<TagBase const*> const& tags, LO nents) {
+  CHECK(can_pack_tags(tags, nents));
+  auto row_bytes = get_packed_row_bytes(tags);
+  Write<I8> rows(nents * row_bytes);
+  Int offset = 0;
+  for (auto tag : tags) {
+    auto ent_bytes = get_ent_bytes(tag);
+    auto in = get_tag_bytes(tag);
+    auto f = LAMBDA(LO e) {
+      for (Int b = 0; b < ent_bytes; ++b) {
+        rows[e * row_bytes + offset + b] = in[e * ent_bytes + b];
+      }
+    };
+    parallel_for(nents, f);
+    offset += ent_bytes;
+  }
+  return rows;
+}
+
+template <typename T>
+static std::shared_ptr<TagBase> unpack_tag(
+    TagBase const* tag, Read<I8> rows, LO nents, Int row_bytes, Int offset) {
+  auto ent_bytes = get_ent_bytes(tag);
+  Write<T> array(nents * tag->ncomps());
+  auto out = reinterpret_cast<I8*>(array.data());
+  auto f = LAMBDA(LO e) {
+    for (Int b = 0; b < ent_bytes; ++b) {
+      out[e * ent_bytes + b] = rows[e * row_bytes + offset + b];
+    }
+  };
+  parallel_for(nents, f);
+  auto new_tag = new Tag<T>(tag->name(), tag->ncomps(), tag->xfer(),
+      tag->outflags());
+  new_tag->set_array(array);
+  return std::shared_ptr<TagBase>(new_tag);
+}
+
+std::vector<std::shared_ptr<TagBase>> unpack_tags(
+    std::vector<TagBase const*> const& tags, Read<I8> rows, LO nents) {
+  CHECK(can_pack_tags(tags, nents));
+  auto row_bytes = get_packed_row_bytes(tags);
+  CHECK(rows.size() == nents * row_bytes);
+  std::vector<std::shared_ptr<TagBase>> out;
+  Int offset = 0;
+  for (auto tag : tags) {
+    switch (tag->type()) {
+      case OMEGA_H_I8:
+        out.push_back(unpack_tag<I8>(tag, rows, nents, row_bytes, offset));
+        break;
+      case OMEGA_H_I32:
+        out.push_back(unpack_tag<I32>(tag, rows, nents, row_bytes, offset));
+        break;
+      case OMEGA_H_I64:
+        out.push_back(unpack_tag<I64>(tag, rows, nents, row_bytes, offset));
+        break;
+      case OMEGA_H_F64:
+        out.push_back(unpack_tag<Real>(tag, rows, nents, row_bytes, offset));
+        break;
+    }
+    offset += get_ent_bytes(tag);
+  }
+  return out;
+}
+
 #define INST(T)                                                                \
   template bool is<T>(TagBase const* t);                                       \
   template Tag<T> const* to<T>(TagBase const* t);                              \
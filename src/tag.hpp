@@ -13,6 +13,30 @@ Tag<T> const* to(TagBase const* t);
 template <typename T>
 Tag<T>* to(TagBase* t);
 
+/* to move many tags at once, their arrays are interleaved
+   byte-wise into one I8 array with a row of
+   get_packed_row_bytes() bytes per entity. Dist::exch of
+   that array with the row size as its width sends one
+   message per neighbor for all the tags together.
+   unpack_tags returns new tags with the same names and
+   flags as the packed ones, holding the unpacked arrays.
+   the packed array is indexed by LO, so group_packable_tags
+   splits the tags into groups that fit for up to max_nents
+   entities. a tag whose row alone does not fit is a group of
+   its own that cannot be packed, and moves as its own array.
+   get_max_packed_rows gives this rank's share of max_nents
+   for an exchange through dist: its sources, their copies
+   and its destinations. callers take the maximum over ranks,
+   so that every rank forms the same groups */
+Int get_packed_row_bytes(std::vector<TagBase const*> const& tags);
+bool can_pack_tags(std::vector<TagBase const*> const& tags, GO max_nents);
+GO get_max_packed_rows(Dist const& dist);
+std::vector<std::vector<TagBase const*>> group_packable_tags(
+    std::vector<TagBase const*> const& tags, GO max_nents);
+Read<I8> pack_tags(std::vector<TagBase const*> const& tags, LO nents);
+std::vector<std::shared_ptr<TagBase>> unpack_tags(
+    std::vector<TagBase const*> const& tags, Read<I8> rows, LO nents);
+
 #define INST_DECL(T)                                                           \
   extern template bool is<T>(TagBase const* t);                                \
   extern template Tag<T> const* to<T>(TagBase const* t);                       \
@@ -8,6 +8,7 @@
 #include "file.hpp"
 #include "graph.hpp"
 #include "hilbert.hpp"
+#include "indset.hpp"
 #include "inertia.hpp"
 #include "int128.hpp"
 #include "internal.hpp"
@@ -23,6 +24,7 @@
 #include "swap2d.hpp"
 #include "swap3d_choice.hpp"
 #include "swap3d_loop.hpp"
+#include "tag.hpp"
 #include "transfer_conserve.hpp"
 #include "vtk.hpp"
 #include "xml.hpp"
@@ -70,10 +72,89 @@ static void test_int128() {
   CHECK(b == a);
 }
 
-static void test_repro_sum() {
+static void test_repro_sum(Library* lib) {
   Reals a({std::exp2(int(20)), std::exp2(int(-20))});
   Real sum = repro_sum(a);
   CHECK(sum == std::exp2(20) + std::exp2(int(-20)));
+  /* the fused multi-component sum agrees with summing
+     each component on its own */
+  auto comm = lib->self();
+  Reals b({1e10, -3.0, 0.5, 1e-10, 7.0, 0.25, 1e10, 1.0, 2.5});
+  Real sums[3];
+  repro_sum(comm, b, 3, sums);
+  for (Int c = 0; c < 3; ++c) {
+    CHECK(sums[c] == repro_sum(comm, get_component(b, 3, c)));
+  }
+  CHECK(sums[1] == 5.0);
+}
+
+static void test_comm_profile(Library* lib) {
+  auto comm = lib->self();
+  comm->allreduce(I32(1), OMEGA_H_SUM);
+  set_comm_profiling(true);
+  {
+    CommRegion region("test:region");
+    comm->allreduce(I32(1), OMEGA_H_SUM);
+    Real x[3] = {1.0, 2.0, 3.0};
+    comm->allreduce(x, 3, OMEGA_H_MAX);
+  }
+  comm->barrier();
+  set_comm_profiling(false);
+  std::stringstream stream;
+  print_comm_profile_json(stream, comm->rank());
+  auto json = stream.str();
+  CHECK(json.find("\"test:region\": {\n      \"allreduce\": "
+                  "{\"calls\": 2, \"bytes\": 28,") != std::string::npos);
+  CHECK(json.find("\"barrier\": {\"calls\": 1,") != std::string::npos);
+  reset_comm_profile();
+  stream.str("");
+  print_comm_profile_json(stream, comm->rank());
+  CHECK(stream.str() == "{\n  \"rank\": 0,\n  \"regions\": {\n  }\n}\n");
+}
+
+static void test_pool() {
+#ifndef OMEGA_H_USE_KOKKOS
+  set_pool_max_cached_bytes(16 * 1000 * 1000);
+  { Write<Real> a(1000 * 1000); }
+  auto hits = get_pool_hits();
+  /* a slightly smaller array falls in the same bucket */
+  { Write<Real> b(1000 * 1000 - 10); }
+  CHECK(get_pool_hits() == hits + 1);
+  CHECK(get_pool_cached_bytes() >= 1000 * 1000 * sizeof(Real));
+  trim_pool();
+  CHECK(get_pool_cached_bytes() == 0);
+  set_pool_max_cached_bytes(1000);
+  { Write<Real> c(1000 * 1000); }
+  CHECK(get_pool_cached_bytes() == 0);
+  /* by default a block as large as the peak usage is not kept */
+  set_pool_max_cached_bytes(0);
+  { Write<Real> d(8 * 1000 * 1000); }
+  CHECK(get_pool_cached_bytes() == 0);
+#endif
+}
+
+static void test_memory_labels() {
+  auto before = get_current_bytes();
+  {
+    MemoryLabel outer("test:outer");
+    Write<Real> a(1000);
+    {
+      MemoryLabel inner("test:inner");
+      Write<Real> b(2000);
+      /* copies made inside a parallel loop must not double-count */
+      auto f = LAMBDA(LO i) { b[i] = a[i % 1000]; };
+      parallel_for(b.size(), f);
+      CHECK(get_current_bytes("test:inner") == 2000 * sizeof(Real));
+    }
+    CHECK(get_current_bytes("test:inner") == 0);
+    CHECK(get_max_bytes("test:inner") == 2000 * sizeof(Real));
+    CHECK(get_current_bytes("test:outer") == 1000 * sizeof(Real));
+  }
+  CHECK(get_current_bytes() == before);
+  CHECK(get_max_bytes("test:outer") == 1000 * sizeof(Real));
+  reset_max_label_bytes();
+  CHECK(get_max_bytes("test:outer") == 0);
+  CHECK(get_max_bytes("test:unused") == 0);
 }
 
 static void test_cubic(Real a, Real b, Real c, Int nroots_wanted,
@@ -208,6 +289,29 @@ static void test_sort() {
   }
 }
 
+template <typename T>
+static void test_sort_against_comparison(Int width, T from, T to) {
+  LO n = 100 * 1000 + 3;
+  Write<T> keys(n * width);
+  auto f = LAMBDA(LO i) {
+    /* few distinct values so that stability matters */
+    auto x = static_cast<T>((I64(i) * 2654435761) % 1009);
+    keys[i] = (x % 2) ? from + x : to - x;
+  };
+  parallel_for(keys.size(), f);
+  auto expected = comparison_sort_by_keys(Read<T>(keys), width);
+  CHECK(sort_by_keys(Read<T>(keys), width) == expected);
+}
+
+static void test_sort_against_comparison() {
+  for (Int width = 1; width <= 3; ++width) {
+    test_sort_against_comparison<LO>(width, -1, 1000 * 1000);
+    test_sort_against_comparison<GO>(width, 0, 1000);
+    /* more than 64 bits in total, one radix pass set per key */
+    test_sort_against_comparison<GO>(width, -(GO(1) << 60), GO(1) << 60);
+  }
+}
+
 static void test_scan() {
   {
     LOs scanned = offset_scan(LOs(3, 1));
@@ -217,6 +321,44 @@ static void test_scan() {
     LOs scanned = offset_scan(Read<I8>(3, 1));
     CHECK(scanned == Read<LO>(4, 0, 1));
   }
+  {
+    /* large enough to span several blocks of a threaded scan */
+    LO n = 100 * 1000 + 7;
+    LOs scanned = offset_scan(LOs(n, 2));
+    CHECK(scanned == LOs(n + 1, 0, 2));
+    Write<LO> a(n, -1);
+    a.set(0, 0);
+    a.set(n / 2, 1);
+    fill_right(a);
+    CHECK(a.get(n / 2 - 1) == 0);
+    CHECK(a.get(n / 2) == 1);
+    CHECK(a.get(n - 1) == 1);
+  }
+}
+
+static void test_reduce_small_team() {
+#if defined(OMEGA_H_USE_OPENMP) && !defined(OMEGA_H_USE_KOKKOS)
+  /* a region nested in an active one gets a team of one
+     thread while omp_get_max_threads() still reports four */
+  auto max_threads = omp_get_max_threads();
+  auto max_levels = omp_get_max_active_levels();
+  omp_set_num_threads(4);
+  omp_set_max_active_levels(1);
+  Real lo = 0;
+  Real hi = 0;
+#pragma omp parallel num_threads(2)
+  {
+#pragma omp master
+    {
+      lo = min(Reals({3, 5, 7, 9}));
+      hi = max(Reals({-3, -5}));
+    }
+  }
+  omp_set_max_active_levels(max_levels);
+  omp_set_num_threads(max_threads);
+  CHECK(lo == 3);
+  CHECK(hi == -3);
+#endif
 }
 
 static void test_fan_and_funnel() {
@@ -257,9 +399,40 @@ static void test_invert_map(Graph (*invert_funcptr)(LOs a2b, LO nb)) {
   }
 }
 
+/* many threads incrementing the same degrees and
+   positions; rows of the atomic inversion may come out
+   in any order, so we compare offsets and check that
+   every row holds exactly the right sources */
+static void test_invert_map_stress() {
+  LO na = 10 * 1000 * 1000;
+  LO nb = na / 10;
+  Write<LO> write_a2b(na);
+  auto f = LAMBDA(LO a) {
+    write_a2b[a] = static_cast<LO>((I64(a) * 2654435761) % nb);
+  };
+  parallel_for(na, f);
+  LOs a2b(write_a2b);
+  auto by_sorting = invert_map_by_sorting(a2b, nb);
+  auto by_atomics = invert_map_by_atomics(a2b, nb);
+  CHECK(by_atomics.a2ab == by_sorting.a2ab);
+  auto b2ba = by_atomics.a2ab;
+  auto ba2a = by_atomics.ab2b;
+  Write<I8> write_ok(nb);
+  auto g = LAMBDA(LO b) {
+    write_ok[b] = 1;
+    for (auto ba = b2ba[b]; ba < b2ba[b + 1]; ++ba) {
+      if (a2b[ba2a[ba]] != b) write_ok[b] = 0;
+    }
+  };
+  parallel_for(nb, g);
+  CHECK(min(Read<I8>(write_ok)) == 1);
+  CHECK(min(mark_image(ba2a, na)) == 1);
+}
+
 static void test_invert_map() {
   test_invert_map(invert_map_by_sorting);
   test_invert_map(invert_map_by_atomics);
+  test_invert_map_stress();
 }
 
 static void test_invert_adj() {
@@ -271,6 +444,11 @@ static void test_invert_adj() {
   CHECK(verts2tris.codes ==
         Read<I8>({make_code(0, 0, 0), make_code(0, 0, 2), make_code(0, 0, 1),
             make_code(0, 0, 2), make_code(0, 0, 0), make_code(0, 0, 1)}));
+  /* reversed globals reverse the order within each row */
+  Read<GO> reversed_globals({1, 0});
+  Adj reversed = invert_adj(tris2verts, 3, 4, reversed_globals);
+  CHECK(reversed.a2ab == verts2tris.a2ab);
+  CHECK(reversed.ab2b == LOs({1, 0, 0, 1, 0, 1}));
 }
 
 static bool same_adj(Int a[], Int b[]) {
@@ -386,6 +564,31 @@ static void test_hilbert() {
           << (Y[2] >> 3 & 1) << (Y[2] >> 2 & 1) << (Y[2] >> 1 & 1)
           << (Y[2] >> 0 & 1) << " = 7865 check";
   CHECK(stream2.str() == expected);
+  hilbert::coord_t W[1];
+  hilbert::transpose_to_words(X, W, 5, 3);
+  CHECK(W[0] == 7865);
+}
+
+static void test_hilbert_packed(Int dim) {
+  LO npts = 1000;
+  Write<Real> coords(npts * dim);
+  auto f = LAMBDA(LO i) {
+    coords[i] = Real((I64(i) * 2654435761) % 1000003) / 1000003.0;
+  };
+  parallel_for(coords.size(), f);
+  /* the full budget is the same integer as dists_from_coords */
+  auto full = hilbert::sort_coords(coords, dim);
+  CHECK(hilbert::sort_coords(coords, dim, dim * MANTISSA_BITS) == full);
+  CHECK(hilbert::get_packed_width(dim, 63) == 1);
+  CHECK(hilbert::get_packed_width(dim, 126) == 2);
+  auto packed = hilbert::packed_dists_from_coords(coords, dim, 63);
+  CHECK(packed.size() == npts);
+  CHECK(min(packed) >= 0);
+}
+
+static void test_hilbert_packed() {
+  test_hilbert_packed(2);
+  test_hilbert_packed(3);
 }
 
 static void test_bbox() {
@@ -435,6 +638,127 @@ static void test_star(Library* lib) {
   }
 }
 
+static void test_cache_budget(Library* lib) {
+  Mesh mesh(lib);
+  build_box(&mesh, 1, 1, 1, 2, 2, 2);
+  auto e2e = mesh.ask_star(EDGE);
+  auto v2e = mesh.ask_up(VERT, EDGE);
+  auto nbytes = mesh.cached_bytes();
+  CHECK(nbytes > 0);
+  /* the most recently used entry is the last to go,
+     and the original downward adjacencies never go */
+  mesh.set_cache_budget(nbytes - 1);
+  CHECK(mesh.cached_bytes() <= nbytes - 1);
+  CHECK(mesh.has_adj(VERT, EDGE));
+  CHECK(mesh.has_adj(TET, TRI));
+  /* evicted entries are rederived on demand */
+  CHECK(mesh.ask_star(EDGE).ab2b == e2e.ab2b);
+  mesh.set_cache_budget(1);
+  CHECK(!mesh.has_adj(EDGE, EDGE));
+  CHECK(!mesh.has_adj(VERT, EDGE));
+  mesh.pin_adj(VERT, EDGE);
+  mesh.ask_up(VERT, EDGE);
+  mesh.ask_qualities();
+  CHECK(mesh.has_adj(VERT, EDGE));
+  CHECK(mesh.has_tag(TET, "quality"));
+  mesh.drop_caches();
+  CHECK(mesh.has_adj(VERT, EDGE));
+  CHECK(!mesh.has_tag(TET, "quality"));
+  mesh.drop_adj(VERT, EDGE);
+  CHECK(!mesh.has_adj(VERT, EDGE));
+  CHECK(mesh.ask_up(VERT, EDGE).ab2b == v2e.ab2b);
+}
+
+static void test_tag_index(Library* lib) {
+  Mesh mesh(lib);
+  build_box(&mesh, 1, 1, 0, 1, 1, 0);
+  auto nvtags = mesh.ntags(VERT);
+  for (Int i = 0; i < 60; ++i) {
+    mesh.add_tag(VERT, std::to_string(i), 1, OMEGA_H_DONT_TRANSFER,
+        OMEGA_H_DONT_OUTPUT, Read<I8>(mesh.nverts(), I8(i)));
+  }
+  mesh.remove_tag(VERT, "10");
+  CHECK(!mesh.has_tag(VERT, "10"));
+  CHECK(mesh.ntags(VERT) == nvtags + 59);
+  /* insertion order is kept for file output */
+  CHECK(mesh.get_tag(VERT, nvtags + 10)->name() == "11");
+  CHECK(mesh.get_array<I8>(VERT, "59").get(0) == 59);
+  mesh.set_tag(VERT, "11", Read<I8>(mesh.nverts(), 3));
+  CHECK(mesh.get_array<I8>(VERT, "11").get(0) == 3);
+}
+
+static GO indset_rounds(Mesh* mesh, Reals quality, IndsetStrategy strategy) {
+  reset_indset_stats();
+  auto in = find_indset(
+      mesh, VERT, quality, Read<I8>(mesh->nverts(), 1), strategy);
+  auto stats = get_indset_stats();
+  CHECK(stats.nsets == 1);
+  /* no two neighbors are both in the set, and every vertex is
+     in it or next to a vertex that is */
+  auto star = mesh->ask_star(VERT);
+  auto h_in = HostRead<I8>(in);
+  auto h_a2ab = HostRead<LO>(star.a2ab);
+  auto h_ab2b = HostRead<LO>(star.ab2b);
+  for (LO v = 0; v < mesh->nverts(); ++v) {
+    bool covered = h_in[v];
+    for (auto vu = h_a2ab[v]; vu < h_a2ab[v + 1]; ++vu) {
+      auto u = h_ab2b[vu];
+      CHECK(!(h_in[v] && h_in[u]));
+      covered = covered || h_in[u];
+    }
+    CHECK(covered);
+  }
+  return stats.nrounds;
+}
+
+static void test_indset_strategies(Library* lib) {
+  Mesh mesh(lib);
+  build_box(&mesh, 1, 1, 0, 64, 1, 0);
+  /* quality rising steadily across the box, the worst case
+     for taking local maxima of quality alone */
+  auto quality = get_component(mesh.coords(), 2, 0);
+  auto quality_rounds = indset_rounds(&mesh, quality, INDSET_QUALITY);
+  auto random_rounds = indset_rounds(&mesh, quality, INDSET_RANDOM);
+  CHECK(quality_rounds > 20);
+  CHECK(random_rounds < quality_rounds / 2);
+}
+
+static void test_pack_tags() {
+  Tag<I8> a("a", 1, OMEGA_H_DONT_TRANSFER, OMEGA_H_DONT_OUTPUT);
+  a.set_array(Read<I8>({1, 2, 3}));
+  Tag<Real> b("b", 2, OMEGA_H_LINEAR_INTERP, OMEGA_H_DO_OUTPUT);
+  b.set_array(Reals({0.5, 1.5, 2.5, 3.5, 4.5, 5.5}));
+  Tag<I64> c("c", 1, OMEGA_H_DONT_TRANSFER, OMEGA_H_DONT_OUTPUT);
+  c.set_array(Read<I64>({-7, 1LL << 40, 9}));
+  std::vector<TagBase const*> tags({&a, &b, &c});
+  CHECK(get_packed_row_bytes(tags) == 1 + 2 * 8 + 8);
+  auto rows = pack_tags(tags, 3);
+  /* reverse the entities, as an exchange might */
+  auto rev = Write<I8>(rows.size());
+  auto f = LAMBDA(LO i) {
+    for (Int j = 0; j < 25; ++j) rev[i * 25 + j] = rows[(2 - i) * 25 + j];
+  };
+  parallel_for(3, f);
+  auto out = unpack_tags(tags, rev, 3);
+  CHECK(out.size() == 3);
+  CHECK(out[1]->name() == "b");
+  CHECK(out[1]->xfer() == OMEGA_H_LINEAR_INTERP);
+  CHECK(to<I8>(out[0].get())->array() == Read<I8>({3, 2, 1}));
+  CHECK(to<Real>(out[1].get())->array() ==
+        Reals({4.5, 5.5, 2.5, 3.5, 0.5, 1.5}));
+  CHECK(to<I64>(out[2].get())->array() == Read<I64>({9, 1LL << 40, -7}));
+  /* rows of up to 17 bytes fit for this many entities */
+  auto groups = group_packable_tags(tags, ArithTraits<LO>::max() / 17);
+  CHECK(groups.size() == 2);
+  CHECK(groups[0].size() == 2);
+  CHECK(groups[1][0] == &c);
+  /* rows of up to 8 bytes: b cannot be packed even alone */
+  groups = group_packable_tags(tags, ArithTraits<LO>::max() / 8);
+  CHECK(groups.size() == 3);
+  CHECK(!can_pack_tags(groups[1], ArithTraits<LO>::max() / 8));
+  CHECK(can_pack_tags(groups[2], ArithTraits<LO>::max() / 8));
+}
+
 static void test_injective_map() {
   LOs primes2ints({2, 3, 5, 7});
   LOs ints2primes = invert_injective_map(primes2ints, 8);
@@ -867,9 +1191,14 @@ int main(int argc, char** argv) {
   test_eigen_cubic();
   test_least_squares();
   test_int128();
-  test_repro_sum();
+  test_pool();
+  test_memory_labels();
+  test_repro_sum(&lib);
+  test_comm_profile(&lib);
   test_sort();
+  test_sort_against_comparison();
   test_scan();
+  test_reduce_small_team();
   test_intersect_metrics();
   test_fan_and_funnel();
   test_permute();
@@ -880,9 +1209,14 @@ int main(int argc, char** argv) {
   test_reflect_down();
   test_find_unique();
   test_hilbert();
+  test_hilbert_packed();
   test_bbox();
   test_build_from_elems2verts(&lib);
   test_star(&lib);
+  test_cache_budget(&lib);
+  test_tag_index(&lib);
+  test_indset_strategies(&lib);
+  test_pack_tags();
   test_injective_map();
   test_dual(&lib);
   test_quality();